@@ -18,6 +18,9 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
 #include <tuple>
 #include <cassert>
 #include <set>
@@ -31,14 +34,24 @@
 #include "headers/ai.h"
 #include "headers/consts.h"
 #include "headers/enums.h"
+#include "headers/bitboard.h"
 
 std::unique_ptr<AI::cache_pointer_type> AI::boardCache = std::make_unique<AI::cache_pointer_type>();
 const Move AI::emptyMove{};
-
-const std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>> 
-    AI::pieceSquareTables = AI::initializeMap();
-
-AI::AI(Board *b) : gameBoard(b) {
+constexpr decltype(AI::MATE) AI::MATE;
+constexpr decltype(AI::DRAW) AI::DRAW;
+
+const std::array<AI::PieceSquareTable, NUM_SQUARE_STATES> AI::pieceSquareTables = AI::initializePieceSquareTables();
+const std::array<AI::PieceSquareTable, 2> AI::kingEndGameTables = AI::initializeKingEndGameTables();
+thread_local std::unique_ptr<AI::PawnTable> AI::pawnTable;
+thread_local PositionHistory AI::searchHistory;
+std::unique_ptr<AI::EvalEntry[]> AI::evalCache = std::make_unique<AI::EvalEntry[]>(AI::EVAL_CACHE_SIZE);
+thread_local uint64_t AI::threadEvalProbes = 0;
+thread_local uint64_t AI::threadEvalHits = 0;
+std::atomic<uint64_t> AI::evalProbes{0};
+std::atomic<uint64_t> AI::evalHits{0};
+
+AI::AI(Board *b, PositionHistory *h) : gameBoard(b), gameHistory(h) {
     timeLimitThread = std::thread{[&](){
         while (isAIActive.load()) {
             if (!isTimeUp.load()) {
@@ -63,236 +76,190 @@ AI::~AI() {
 }
 
 /**
- * Evaluates the current board state from the perspective of the current player
- * to move with a positive number favouring white, and a negative one favouring black.
+ * Scores the mobility of one player from their own perspective, without generating any moves.
+ * Each piece other than pawns counts the squares it attacks that are neither occupied by a friendly piece
+ * nor attacked by an enemy pawn, since a piece moving there could simply be captured by the pawn.
  */
-int AI::evaluate(Board& board) {
-    int currScore = 0;
-    std::vector<Move> whiteMoveList;
-    std::vector<Move> blackMoveList;
-    
-    std::vector<int> whiteRookFiles;
-    std::vector<int> blackRookFiles;
+template<Colour colour>
+int AI::evaluateMobility(const Board& board) const {
+    const auto occupancy = board.getOccupancy();
+    const auto safeTargets = ~board.getColourBoard(colour) 
+        & ~getPawnAttackSet(board.getPieceBoard(PieceTypes::PAWN, getOppositeColour(colour)), getOppositeColour(colour));
     
-    //Array to store pawn counts on a per-file basis with white being 0-7, black 8-15
-    std::array<int, 16> filePawnCount{{0}};
+    int count = popCount(getKingAttacks(board.getKingSquare(colour)) & safeTargets);
     
-    if (board.isWhiteTurn) {
-        whiteMoveList = board.moveGen.generateAll();
-        board.isWhiteTurn = false;
-        blackMoveList = board.moveGen.generateAll();
-        board.isWhiteTurn = true;
-    } else {
-        blackMoveList = board.moveGen.generateAll();
-        board.isWhiteTurn = true;
-        whiteMoveList = board.moveGen.generateAll();
-        board.isWhiteTurn = false;
+    auto knights = board.getPieceBoard(PieceTypes::KNIGHT, colour);
+    while (knights) {
+        count += popCount(getKnightAttacks(popLowestSquare(knights)) & safeTargets);
+    }
+    auto diagonals = board.getPieceBoard(PieceTypes::BISHOP, colour) | board.getPieceBoard(PieceTypes::QUEEN, colour);
+    while (diagonals) {
+        count += popCount(getBishopAttacks(popLowestSquare(diagonals), occupancy) & safeTargets);
+    }
+    auto orthogonals = board.getPieceBoard(PieceTypes::ROOK, colour) | board.getPieceBoard(PieceTypes::QUEEN, colour);
+    while (orthogonals) {
+        count += popCount(getRookAttacks(popLowestSquare(orthogonals), occupancy) & safeTargets);
     }
+    return count * MOBILITY_VAL;
+}
 
-    const auto whiteTotalMoves = whiteMoveList.size();
-    const auto blackTotalMoves = blackMoveList.size();
+/**
+ * Scores the material and piece placement of one player from their own perspective.
+ * Material comes from the piece counts, and only the squares of existing pieces are visited for the
+ * piece square tables, picking the king table for the current game phase.
+ * Rooks on the seventh are counted straight from the piece sets.
+ */
+template<Colour colour>
+int AI::evaluatePieces(const Board& board, const bool isEndGame) const {
+    constexpr auto isWhite = (colour == Colour::WHITE);
+    //Ranks counted from the player's own side
+    constexpr auto seventhRank = (isWhite) ? (RANK_8_MASK >> INNER_BOARD_SIZE) : (RANK_1_MASK << INNER_BOARD_SIZE);
+    int score = 0;
     
-    const auto cornerIndex = board.findCorner_1D();
-
-    auto endGamePieceCount = 0;
-    auto whiteKingIndex = -1;
-    auto blackKingIndex = -1;
-
-    currScore += (whiteTotalMoves - blackTotalMoves) * MOBILITY_VAL;
+    for (const auto type : PIECE_TYPE_LIST) {
+        score += getPieceValue(type) * board.getPieceCount(type, colour);
+        
+        const auto& table = (type == PieceTypes::KING && isEndGame) 
+            ? kingEndGameTables[getColourIndex(colour)] : pieceSquareTables[getPieceCode(type, colour)];
+        auto pieces = board.getPieceBoard(type, colour);
+        while (pieces) {
+            //Piece square tables are indexed with a8 as square 0
+            score += table[popLowestSquare(pieces) ^ 56];
+        }
+    }
     
-    currScore -= reduceKnightMobilityScore(whiteMoveList, cornerIndex, board);
-    currScore += reduceKnightMobilityScore(blackMoveList, cornerIndex, board);
+    score += ROOK_SEVEN_VAL * popCount(board.getPieceBoard(PieceTypes::ROOK, colour) & seventhRank);
+    return score;
+}
+
+/**
+ * Scores the pawn structure of one player from their own perspective.
+ * Pawns on the sixth and seventh ranks get a bonus, each file with more than one pawn is penalized
+ * per extra pawn, and each file of pawns with no friendly pawns on the neighbouring files is penalized as isolated.
+ */
+template<Colour colour>
+int AI::evaluatePawnStructure(const Board& board) const {
+    constexpr auto isWhite = (colour == Colour::WHITE);
+    //Ranks counted from the player's own side
+    constexpr auto seventhRank = (isWhite) ? (RANK_8_MASK >> INNER_BOARD_SIZE) : (RANK_1_MASK << INNER_BOARD_SIZE);
+    constexpr auto sixthRank = (isWhite) ? (seventhRank >> INNER_BOARD_SIZE) : (seventhRank << INNER_BOARD_SIZE);
+    const auto pawns = board.getPieceBoard(PieceTypes::PAWN, colour);
+    int score = (PAWN_SEVEN_VAL * popCount(pawns & seventhRank)) + (PAWN_SIX_VAL * popCount(pawns & sixthRank));
     
-    //Counting material values
-    for(int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for(int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            const auto currPiece = board.vectorTable[cornerIndex + (i * OUTER_BOARD_SIZE) + j]->getPiece();
-            
-            if (currPiece) {
-                if (currPiece->getType() != PieceTypes::KING) {
-                    //Non-king piece square table lookup
-                    const auto& elem = pieceSquareTables.find(*currPiece);
-
-                    if (currPiece->getColour() == Colour::WHITE) {
-                        //Material value
-                        currScore += getPieceValue(currPiece->getType());
-                        //Piece square lookup
-                        currScore += elem->second[Board::convertOuterBoardIndex(cornerIndex + (i * OUTER_BOARD_SIZE) + j, cornerIndex)];
-                        
-                        //Check for rook on the seventh and store the file
-                        if (currPiece->getType() == PieceTypes::ROOK) {
-                            if (i == 1) {
-                                currScore += ROOK_SEVEN_VAL;
-                            }
-                            whiteRookFiles.push_back(j);
-                        }
-                        //Check for pawn on the sixth and seventh, and store the file
-                        if (currPiece->getType() == PieceTypes::PAWN) {
-                            ++filePawnCount[j];
-                            if (i == 1) {
-                                currScore += PAWN_SEVEN_VAL;
-                            } else if (i == 2) {
-                                currScore += PAWN_SIX_VAL;
-                            }
-                        } else {
-                            ++endGamePieceCount;
-                        }
-                    } else {
-                        //Material value
-                        currScore -= getPieceValue(currPiece->getType());
-                        //Piece square lookup
-                        currScore -= elem->second[Board::convertOuterBoardIndex(cornerIndex + (i * OUTER_BOARD_SIZE) + j, cornerIndex)];
-                        
-                        //Check for rook on the seventh and store the file
-                        if (currPiece->getType() == PieceTypes::ROOK) {
-                            if (i == 6) {
-                                currScore -= ROOK_SEVEN_VAL;
-                            }
-                            blackRookFiles.push_back(j);
-                        }
-                        //Check for pawn on the sixth and seventh, and store the file
-                        if (currPiece->getType() == PieceTypes::PAWN) {
-                            ++filePawnCount[j + INNER_BOARD_SIZE];
-                            if (i == 6) {
-                                currScore -= PAWN_SEVEN_VAL;
-                            } else if (i == 5) {
-                                currScore -= PAWN_SIX_VAL;
-                            }
-                        } else {
-                            ++endGamePieceCount;
-                        }
-                    }
-                } else {
-                    if (currPiece->getColour() == Colour::WHITE) {
-                        //Material value
-                        currScore += getPieceValue(currPiece->getType());
-                        whiteKingIndex = Board::convertOuterBoardIndex(cornerIndex + (i * OUTER_BOARD_SIZE) + j, cornerIndex);
-                    } else {
-                        //Material value
-                        currScore -= getPieceValue(currPiece->getType());
-                        blackKingIndex = Board::convertOuterBoardIndex(cornerIndex + (i * OUTER_BOARD_SIZE) + j, cornerIndex);
-                    }
-                }
-            }
+    for (int file = 0; file < INNER_BOARD_SIZE; ++file) {
+        const auto fileMask = FILE_A_MASK << file;
+        const auto count = popCount(pawns & fileMask);
+        if (!count) {
+            continue;
+        }
+        if (count > 1) {
+            score -= DOUBLED_PAWN_PENALTY * (count - 1);
+        }
+        const auto neighbourMask = ((fileMask << 1) & ~FILE_A_MASK) | ((fileMask >> 1) & ~FILE_H_MASK);
+        if (!(pawns & neighbourMask)) {
+            score -= ISOLATED_PAWN_PENALTY;
         }
     }
+    return score;
+}
 
-    assert(whiteKingIndex != -1);
-    assert(blackKingIndex != -1);
-
-    if (endGamePieceCount <= 4) {
-        //Endgame
-        const auto& whiteKingTable = pieceSquareTables.equal_range({PieceTypes::KING, Colour::WHITE});
-        const auto& blackKingTable = pieceSquareTables.equal_range({PieceTypes::KING, Colour::BLACK});
-
-        currScore += whiteKingTable.second->second[whiteKingIndex];
-        currScore += blackKingTable.second->second[blackKingIndex];
-    } else {
-        //Not endgame
-        const auto& whiteKingTable = pieceSquareTables.equal_range({PieceTypes::KING, Colour::WHITE});
-        const auto& blackKingTable = pieceSquareTables.equal_range({PieceTypes::KING, Colour::BLACK});
-
-        currScore += whiteKingTable.first->second[whiteKingIndex];
-        currScore += blackKingTable.first->second[blackKingIndex];
+/**
+ * Looks up the pawn structure terms for the current pawns in this thread's pawn table, filling in the entry on a miss.
+ * Pawns change far less often than the rest of the position, so most evaluations skip the pawn terms entirely.
+ */
+const AI::PawnEntry& AI::probePawnTable(const Board& board) const {
+    if (!pawnTable) {
+        pawnTable = std::make_unique<PawnTable>();
     }
+    auto& entry = (*pawnTable)[board.getPawnHash() & (PAWN_TABLE_SIZE - 1)];
+    if (!entry.valid || entry.key != board.getPawnHash()) {
+        entry.valid = true;
+        entry.key = board.getPawnHash();
+        entry.score = evaluatePawnStructure<Colour::WHITE>(board) - evaluatePawnStructure<Colour::BLACK>(board);
+        entry.fileMasks[getColourIndex(Colour::WHITE)] = getOccupiedFiles(board.getPieceBoard(PieceTypes::PAWN, Colour::WHITE));
+        entry.fileMasks[getColourIndex(Colour::BLACK)] = getOccupiedFiles(board.getPieceBoard(PieceTypes::PAWN, Colour::BLACK));
+    }
+    return entry;
+}
+
+/**
+ * Evaluates the current board state from the perspective of the current player
+ * to move with a positive number favouring white, and a negative one favouring black.
+ * Scores are looked up in the evaluation cache by the position hash first, and only computed on a miss.
+ * The fifty move rule depends on the half move clock, which is not part of the hash, so it is applied after the lookup.
+ */
+int AI::evaluate(Board& board) {
+    auto& entry = evalCache[board.getCurrHash() & (EVAL_CACHE_SIZE - 1)];
+    const auto data = entry.data.load(std::memory_order_relaxed);
+    const auto checkedKey = entry.checkedKey.load(std::memory_order_relaxed);
     
-    for (int i = 0; i < 16; ++i) {
-        if (filePawnCount[i] > 1) {
-            if (i > 7) {
-                currScore += DOUBLED_PAWN_PENALTY * (filePawnCount[i] - 1);
-            } else {
-                currScore -= DOUBLED_PAWN_PENALTY * (filePawnCount[i] - 1);
-            }
-        } else if (!filePawnCount[i]) {
-            if (i <= 13 && filePawnCount[i + 1] && !filePawnCount[i + 2]) {
-                if (i > 7) {
-                    currScore += ISOLATED_PAWN_PENALTY;
-                } else {
-                    currScore -= ISOLATED_PAWN_PENALTY;
-                }
-            }
-        }
-        if (i <= 7) {
-            if (!filePawnCount[i] || !filePawnCount[i + INNER_BOARD_SIZE]) {
-                if (!filePawnCount[i] && !filePawnCount[i + INNER_BOARD_SIZE]) {
-                    //Open file
-                    for (const int currFile : whiteRookFiles) {
-                        if (currFile == i) {
-                            currScore += OPEN_FILE_VAL;
-                        }
-                    }
-                    for (const int currFile : blackRookFiles) {
-                        if (currFile == i) {
-                            currScore -= OPEN_FILE_VAL;
-                        }
-                    }
-                } else {
-                    //Semi open
-                    for (const int currFile : whiteRookFiles) {
-                        if (currFile == i) {
-                            currScore += HALF_OPEN_FILE_VAL;
-                        }
-                    }
-                    for (const int currFile : blackRookFiles) {
-                        if (currFile == i) {
-                            currScore -= HALF_OPEN_FILE_VAL;
-                        }
-                    }
-                }
-            }
+    int score;
+    if ((checkedKey ^ data) == board.getCurrHash()) {
+        score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        if (trackEvalCacheStats) {
+            ++threadEvalHits;
         }
+    } else {
+        score = computeEvaluation(board);
+        const auto newData = static_cast<uint64_t>(static_cast<uint32_t>(score));
+        entry.checkedKey.store(board.getCurrHash() ^ newData, std::memory_order_relaxed);
+        entry.data.store(newData, std::memory_order_relaxed);
+    }
+    if (trackEvalCacheStats) {
+        ++threadEvalProbes;
     }
     
-    //End game eval conditions
-    if (!whiteMoveList.size()) {
-        currScore = -MATE * board.whiteInCheck;
-    } else if (!blackMoveList.size()) {
-        currScore = MATE * board.blackInCheck;
-    } else if (board.halfMoveClock >= 100) {
-        currScore = 0;
-    } else if (board.repititionList[0] == board.repititionList[4] 
-            && board.repititionList[4] == board.repititionList[8]) {
-        currScore = 0;
-    } else if (board.drawByMaterial()) {
-        currScore = 0;
+    if (board.halfMoveClock >= 100 && std::abs(score) != MATE) {
+        return 0;
     }
-    return currScore;
+    return score;
 }
 
 /**
- * The evaulation function uses piece mobility as a metric.
- * Knights that have their perspective squares guarded by enemy pawns should not consider those squares viable moves due
- * to an easy capture of the knight.
- * This method removes those squares from a knight's mobility list, effectively reducing its bonus based on how
- * corralled it is by enemy pawns.
+ * Computes the static evaluation of a position, excluding the fifty move rule.
+ * A player to move with no legal moves is checkmated or stalemated, which is found by stopping
+ * at their first legal move rather than generating them.
  */
-int AI::reduceKnightMobilityScore(const std::vector<Move>& moveList, const int cornerIndex, const Board& board) const {
-    static constexpr int pawnThreatOffsets[] = {14, 16, -14, -16};
-    auto totalToRemove = 0;
-    auto cornerCheckIndex = 0;
+int AI::computeEvaluation(Board& board) {
+    if (!board.getMoveGen().hasLegalMove()) {
+        if (board.checkers) {
+            return (board.isWhiteTurn) ? -MATE : MATE;
+        }
+        return DRAW;
+    }
     
-    for(const auto& mv : moveList) {
-        if (mv.fromPieceType == PieceTypes::KNIGHT) {
-            //Calculate index of destination square without requiring linear search
-            const auto cornerToSqDiff = board.moveGen.getOffsetIndex(
-                mv.toSq->getOffset() - board.vectorTable[cornerIndex]->getOffset(), cornerIndex);
-                
-            for (int i = 0; i < 4; ++i) {
-                cornerCheckIndex = board.moveGen.getOffsetIndex(pawnThreatOffsets[i], cornerToSqDiff);
-                if (cornerCheckIndex < 0 || cornerCheckIndex >= TOTAL_BOARD_SIZE) {
-                    continue;
-                }
-                
-                const auto& knightMoveNeighbour = board.vectorTable[cornerCheckIndex]->getPiece();
-                
-                if (knightMoveNeighbour && knightMoveNeighbour->getType() == PieceTypes::PAWN
-                        && knightMoveNeighbour->getColour() != mv.fromPieceColour) {
-                    totalToRemove += MOBILITY_VAL;
-                }
+    int currScore = evaluateMobility<Colour::WHITE>(board) - evaluateMobility<Colour::BLACK>(board);
+    
+    //The endgame starts once there are at most four pieces left other than pawns and kings
+    const auto pawns = board.getPieceBoard(PieceTypes::PAWN, Colour::WHITE) | board.getPieceBoard(PieceTypes::PAWN, Colour::BLACK);
+    const auto kings = board.getPieceBoard(PieceTypes::KING, Colour::WHITE) | board.getPieceBoard(PieceTypes::KING, Colour::BLACK);
+    const auto isEndGame = (popCount(board.getOccupancy() & ~(pawns | kings)) <= 4);
+    
+    currScore += evaluatePieces<Colour::WHITE>(board, isEndGame) - evaluatePieces<Colour::BLACK>(board, isEndGame);
+    
+    const auto& pawnEntry = probePawnTable(board);
+    currScore += pawnEntry.score;
+    
+    //Rooks on files without pawns of one or both colours
+    const auto whiteFiles = pawnEntry.fileMasks[getColourIndex(Colour::WHITE)];
+    const auto blackFiles = pawnEntry.fileMasks[getColourIndex(Colour::BLACK)];
+    const auto getRookFileScore = [whiteFiles, blackFiles](Bitboard rooks) {
+        int score = 0;
+        while (rooks) {
+            const auto fileBit = 1 << getFile(popLowestSquare(rooks));
+            if (!(whiteFiles & blackFiles & fileBit)) {
+                score += ((whiteFiles | blackFiles) & fileBit) ? HALF_OPEN_FILE_VAL : OPEN_FILE_VAL;
             }
         }
+        return score;
+    };
+    currScore += getRookFileScore(board.getPieceBoard(PieceTypes::ROOK, Colour::WHITE)) 
+        - getRookFileScore(board.getPieceBoard(PieceTypes::ROOK, Colour::BLACK));
+    
+    if (board.drawByMaterial()) {
+        currScore = 0;
     }
-    return totalToRemove;
+    return currScore;
 }
 
 /**
@@ -317,16 +284,48 @@ int AI::getPieceValue(const PieceTypes type) const {
     }
 }
 
+/**
+ * Generates one stage of the moves searched from a position.
+ * Captures and promotions come first and quiet moves second, so at nodes where a capture cuts off
+ * the quiet moves are never generated. When in check, every evasion is generated in the first stage.
+ * With PSEUDO_LEGAL_SEARCH disabled, every legal move is generated in the first stage instead.
+ */
+MoveList AI::generateSearchMoves(const Board& board, const int stage) {
+    if (board.checkers) {
+        return (stage == 0) ? board.getMoveGen().generateEvasions() : MoveList{};
+    }
+    if (!usePseudoLegalSearch) {
+        return (stage == 0) ? board.getMoveGen().generateAll() : MoveList{};
+    }
+    return (stage == 0) ? board.getMoveGen().generateCaptures() : board.getMoveGen().generateQuiets();
+}
+
+/**
+ * Returns the type of the piece captured by a move, or UNKNOWN if the move is quiet.
+ */
+PieceTypes AI::getCapturedType(const Move mv, const Board& board) {
+    return (mv.isEnPassant()) ? PieceTypes::PAWN : board.getPieceType(mv.getToSq());
+}
+
+bool AI::isCapture(const Move mv, const Board& board) {
+    return getCapturedType(mv, board) != PieceTypes::UNKNOWN;
+}
+
 /**
  * General search method used for initiating the AI's search, and performing the best found move.
  */
 std::string AI::search() {
     auto result = iterativeDeepening();
+    if (trackEvalCacheStats) {
+        printEvalCacheStats();
+    }
     prev = std::get<0>(result);
-    previousToSquareIndex = gameBoard->convertOuterBoardIndex(gameBoard->getSquareIndex(std::get<0>(result).toSq), gameBoard->findCorner_1D());
+    previousCounterMoveIndex = (getPieceIndex(gameBoard->getPieceType(prev.getFromSq())) 
+            * INNER_BOARD_SIZE * INNER_BOARD_SIZE) + prev.getToSq();
     const auto moveText = gameBoard->convertMoveToCoordText(std::get<0>(result));
+    gameHistory->push(gameBoard->getCurrHash());
     gameBoard->makeMove(std::get<0>(result));
-    gameBoard->detectGameEnd();
+    gameBoard->detectGameEnd(*gameHistory);
     return moveText;
 }
 
@@ -337,8 +336,8 @@ std::string AI::search() {
  * These results are then aggregated based on depth and returned.
  * The rest of the code is used for handling move time limits.
  */
-std::tuple<Move, int, int, int, int> AI::iterativeDeepening() {
-    auto firstGuess = std::make_tuple(emptyMove, 0, -1, -1, -1);
+std::pair<Move, int> AI::iterativeDeepening() {
+    auto firstGuess = std::make_pair(emptyMove, 0);
     int evalGuess;
     std::atomic_int maxDepth{0};
     {
@@ -349,6 +348,7 @@ std::tuple<Move, int, int, int, int> AI::iterativeDeepening() {
 #pragma omp parallel default(none) private(evalGuess) firstprivate(gameBoard) shared(firstGuess, maxDepth, isTimeUp)
     {
         Board b{*gameBoard};
+        searchHistory = *gameHistory;
 #pragma omp for schedule(guided)
         for (int i = 1; i <= DEPTH + (99 * usingTimeLimit); ++i) {
 #pragma omp atomic read
@@ -364,18 +364,34 @@ std::tuple<Move, int, int, int, int> AI::iterativeDeepening() {
             }
 #pragma omp cancellation point for
         }
+        if (trackEvalCacheStats) {
+            evalProbes += threadEvalProbes;
+            evalHits += threadEvalHits;
+            threadEvalProbes = 0;
+            threadEvalHits = 0;
+        }
     }
-    translateMovePointers(*gameBoard, std::get<0>(firstGuess), std::forward_as_tuple(std::get<2>(firstGuess), std::get<3>(firstGuess), std::get<4>(firstGuess)));
     return firstGuess;
 }
 
+/**
+ * Prints the evaluation cache hit rate and memory use gathered over all searches so far.
+ */
+void AI::printEvalCacheStats() const {
+    const auto probes = evalProbes.load();
+    const auto hits = evalHits.load();
+    std::cout << "Eval cache: " << EVAL_CACHE_SIZE << " entries (" << ((EVAL_CACHE_SIZE * sizeof(EvalEntry)) >> 20ul) 
+        << " MB), " << hits << " hits out of " << probes << " probes (" 
+        << ((probes) ? (100.0 * hits / probes) : 0.0) << "%)\n";
+}
+
 /**
  * MTD(f) is called from inside the iterative deepening function.
  * It performs repeated null window alpha beta searches to attempt a faster and more efficient
  * convergence on the true value of a given board state.
  */
-std::tuple<Move, int, int, int, int> AI::MTD(const int firstGuess, const int depth, Board& board) {
-    auto currGuess = std::make_tuple(emptyMove, firstGuess, -1, -1, -1);
+std::pair<Move, int> AI::MTD(const int firstGuess, const int depth, Board& board) {
+    auto currGuess = std::make_pair(emptyMove, firstGuess);
     int upper = INT_MAX;
     int lower = INT_MIN;
     int beta = 0;
@@ -397,22 +413,23 @@ std::tuple<Move, int, int, int, int> AI::MTD(const int firstGuess, const int dep
  * It is called with a null window by MTDF above.
  * This function performs transposition table lookup and storage, as well as game tree traversal.
  */
-std::tuple<Move, int, int, int, int> AI::AlphaBeta(int alpha, int beta, const int depth, Board& board) {
+std::pair<Move, int> AI::AlphaBeta(int alpha, int beta, const int depth, Board& board) {
     assert(depth >= 0);
-    auto rtn = std::make_tuple(emptyMove, INT_MIN, -1, -1, -1);
+    auto rtn = std::make_pair(emptyMove, INT_MIN);
+
+    //A position repeated below the root is scored as a draw without being searched any further
+    if (searchHistory.size() > gameHistory->size() && searchHistory.isRepetition(board)) {
+        return std::make_pair(emptyMove, static_cast<int>(DRAW));
+    }
 
     if (boardCache->retrieve(board)) {
         int entryDepth;
         int entryValue;
         SearchBoundary entryType;
-        std::tuple<int, int, int> moveConversionOffsets;
-        int fromOffset;
-        int toOffset;
-        int targetOffset;
-        std::tie(entryDepth, entryValue, entryType, std::get<0>(rtn), fromOffset, toOffset, targetOffset) = (*boardCache)[board];
+        std::tie(entryDepth, entryValue, entryType, std::get<0>(rtn)) = (*boardCache)[board];
         if (entryDepth >= depth) {
             if (entryType == SearchBoundary::EXACT) {
-                return std::make_tuple(std::get<0>(rtn), entryValue, fromOffset, toOffset, targetOffset);
+                return std::make_pair(std::get<0>(rtn), entryValue);
             }
             //Update the best move based on the previous value
             if (entryType == SearchBoundary::LOWER && entryValue > alpha) {
@@ -422,19 +439,18 @@ std::tuple<Move, int, int, int, int> AI::AlphaBeta(int alpha, int beta, const in
             }
             if (alpha >= beta) {
                 //Return the best move as well
-                return std::make_tuple(std::get<0>(rtn), entryValue, fromOffset, toOffset, targetOffset);
+                return std::make_pair(std::get<0>(rtn), entryValue);
             }
         }
-        translateMovePointers(board, std::get<0>(rtn), std::forward_as_tuple(fromOffset, toOffset, targetOffset));
-
         //If cache entry is invalid due to hash collision, ignore it
-        if (std::get<0>(rtn) != emptyMove && !board.moveGen.validateMove(std::get<0>(rtn), true)) {
-            rtn = std::make_tuple(emptyMove, INT_MIN, -1, -1, -1);
+        if (std::get<0>(rtn) != emptyMove && !(board.getMoveGen().isPseudoLegal(std::get<0>(rtn)) 
+                    && board.getMoveGen().isLegal(std::get<0>(rtn)))) {
+            rtn = std::make_pair(emptyMove, INT_MIN);
         }
     }
     
     if (depth == 0) {
-        rtn = std::make_tuple(emptyMove, evaluate(board), -1, -1, -1);
+        rtn = std::make_pair(emptyMove, evaluate(board));
     } else if (board.isWhiteTurn) {
         //Maximizing player
         int a = alpha;
@@ -442,180 +458,154 @@ std::tuple<Move, int, int, int, int> AI::AlphaBeta(int alpha, int beta, const in
         
         //Make the move if it was found in the cache
         if (std::get<0>(rtn) != emptyMove) {
-            board.makeMove(std::get<0>(rtn)); 
-            const auto abCall = AlphaBeta(a, beta, depth - 1, board);
+            const auto abCall = searchMove(std::get<0>(rtn), a, beta, depth - 1, board);
             
             if (std::get<1>(abCall) > std::get<1>(rtn)) {
-                const auto cornerIndex = board.findCorner_1D();
-
-                rtn = std::forward_as_tuple(
-                        std::get<0>(rtn), 
-                        std::get<1>(abCall), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).fromSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).toSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).enPassantTarget), cornerIndex)
-                );
+                std::get<1>(rtn) = std::get<1>(abCall);
             }
             a = std::max(a, std::get<1>(rtn));
-            board.unmakeMove(std::get<0>(rtn));
         }
 
-        auto moveList = orderMoveList(board.moveGen.generateAll(), board);
-        const auto moveListSize = moveList.size();
+        auto firstLegalMove = emptyMove;
+        bool isSearchStopped = false;
 
-        //Evalulate the board if the current position is a checkmate or stalemate
-        if (moveListSize == 0) {
-            rtn = std::make_tuple(emptyMove, evaluate(board), -1, -1, -1);
-            return rtn;
-        }
+        //Traverses the game tree, only generating each stage of moves if the previous stages did not cut off
+        for (int stage = 0; !isSearchStopped && std::get<1>(rtn) < beta && stage < NUM_SEARCH_STAGES; ++stage) {
+            auto moveList = generateSearchMoves(board, stage);
+            orderMoveList(moveList, board);
+            const auto moveListSize = moveList.size();
+            
+            for (size_t i = 0; std::get<1>(rtn) < beta && i < moveListSize; ++i) {
+                //Pseudo-legal moves are only checked for legality once they are about to be searched
+                if (usePseudoLegalSearch && !board.getMoveGen().isLegal(moveList[i])) {
+                    continue;
+                }
+                if (firstLegalMove == emptyMove) {
+                    firstLegalMove = moveList[i];
+                }
+                const auto abCall = searchMove(moveList[i], a, beta, depth - 1, board);
 
-        //Traverses the game tree
-        for (size_t i = 0; std::get<1>(rtn) < beta && i < moveListSize; ++i) {
-            board.makeMove(moveList[i]);
-            const auto abCall = AlphaBeta(a, beta, depth - 1, board);
+                if (std::get<1>(abCall) > std::get<1>(rtn)) {
+                    rtn = std::make_pair(moveList[i], std::get<1>(abCall));
 
-            if (std::get<1>(abCall) > std::get<1>(rtn)) {
-                const auto cornerIndex = board.findCorner_1D();
-
-                rtn = std::forward_as_tuple(
-                        moveList[i],
-                        std::get<1>(abCall), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].fromSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].toSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].enPassantTarget), cornerIndex)
-                );
-
-                if (usingTimeLimit && isTimeUp.load()) {
-                    board.unmakeMove(std::get<0>(rtn));
-                    break;
+                    if (usingTimeLimit && isTimeUp.load()) {
+                        isSearchStopped = true;
+                        break;
+                    }
                 }
-            }
 
-            a = std::max(a, std::get<1>(rtn));
-            board.unmakeMove(moveList[i]);
+                a = std::max(a, std::get<1>(rtn));
+            }
+        }
+        
+        //Score the position directly if it is a checkmate or stalemate
+        if (firstLegalMove == emptyMove && std::get<0>(rtn) == emptyMove) {
+            rtn = std::make_pair(emptyMove, (board.checkers) ? -MATE : DRAW);
+            return rtn;
         }
         
-        //If no cutoff was found by the previous loop, default to the first move in the list
-        if (moveListSize > 0 && std::get<0>(rtn) == emptyMove) {
-            const auto cornerIndex = board.findCorner_1D();
-
-            rtn = std::forward_as_tuple(
-                    moveList[0],
-                    a,
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].fromSq), cornerIndex),
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].toSq), cornerIndex),
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].enPassantTarget), cornerIndex)
-            );
+        //If no cutoff was found by the previous loop, default to the first legal move in the list
+        if (std::get<0>(rtn) == emptyMove) {
+            rtn = std::make_pair(firstLegalMove, a);
         }
     } else {
         //Minimizing player
         int b = beta;
         std::get<1>(rtn) = INT_MAX;
 
+        //Make the move if it was found in the cache
         if (std::get<0>(rtn) != emptyMove) {
-            board.makeMove(std::get<0>(rtn)); //Make the move if it was found in the cache
-            const auto abCall = AlphaBeta(alpha, b, depth - 1, board);
+            const auto abCall = searchMove(std::get<0>(rtn), alpha, b, depth - 1, board);
             
             if (std::get<1>(abCall) < std::get<1>(rtn)) {
-                const auto cornerIndex = board.findCorner_1D();
-
-                rtn = std::forward_as_tuple(
-                        std::get<0>(rtn), 
-                        std::get<1>(abCall), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).fromSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).toSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).enPassantTarget), cornerIndex)
-                );
+                std::get<1>(rtn) = std::get<1>(abCall);
             }
             b = std::min(b, std::get<1>(rtn));
-            board.unmakeMove(std::get<0>(rtn));
         }
 
-        auto moveList = orderMoveList(board.moveGen.generateAll(), board);
-        const auto moveListSize = moveList.size();
+        auto firstLegalMove = emptyMove;
+        bool isSearchStopped = false;
 
-        //Evalulate the board if the current position is a checkmate or stalemate
-        if (moveListSize == 0) {
-            rtn = std::make_tuple(emptyMove, evaluate(board), -1, -1, -1);
-            return rtn;
-        }
+        //Traverses the game tree, only generating each stage of moves if the previous stages did not cut off
+        for (int stage = 0; !isSearchStopped && std::get<1>(rtn) > alpha && stage < NUM_SEARCH_STAGES; ++stage) {
+            auto moveList = generateSearchMoves(board, stage);
+            orderMoveList(moveList, board);
+            const auto moveListSize = moveList.size();
+            
+            for (size_t i = 0; std::get<1>(rtn) > alpha && i < moveListSize; ++i) {
+                //Pseudo-legal moves are only checked for legality once they are about to be searched
+                if (usePseudoLegalSearch && !board.getMoveGen().isLegal(moveList[i])) {
+                    continue;
+                }
+                if (firstLegalMove == emptyMove) {
+                    firstLegalMove = moveList[i];
+                }
+                const auto abCall = searchMove(moveList[i], alpha, b, depth - 1, board);
 
-        //Traverses the game tree
-        for (size_t i = 0; std::get<1>(rtn) > alpha && i < moveListSize; ++i) {
-            board.makeMove(moveList[i]);
-            const auto abCall = AlphaBeta(alpha, b, depth - 1, board);
+                if (std::get<1>(abCall) < std::get<1>(rtn)) {
+                    rtn = std::make_pair(moveList[i], std::get<1>(abCall));
 
-            if (std::get<1>(abCall) < std::get<1>(rtn)) {
-                const auto cornerIndex = board.findCorner_1D();
-
-                rtn = std::forward_as_tuple(
-                        moveList[i],
-                        std::get<1>(abCall), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].fromSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].toSq), cornerIndex),
-                        board.convertOuterBoardIndex(board.getSquareIndex(moveList[i].enPassantTarget), cornerIndex)
-                );
-
-                if (usingTimeLimit && isTimeUp.load()) {
-                    board.unmakeMove(std::get<0>(rtn));
-                    break;
+                    if (usingTimeLimit && isTimeUp.load()) {
+                        isSearchStopped = true;
+                        break;
+                    }
                 }
+                b = std::min(b, std::get<1>(rtn));
             }
-            b = std::min(b, std::get<1>(rtn));
-            board.unmakeMove(moveList[i]);
         }
-        //If no cutoff was found by the previous loop, default to the first move in the list
-        if (moveListSize > 0 && std::get<0>(rtn) == emptyMove) {
-            const auto cornerIndex = board.findCorner_1D();
-            rtn = std::forward_as_tuple(
-                    moveList[0],
-                    b,
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].fromSq), cornerIndex),
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].toSq), cornerIndex),
-                    board.convertOuterBoardIndex(board.getSquareIndex(moveList[0].enPassantTarget), cornerIndex)
-            );
+        
+        //Score the position directly if it is a checkmate or stalemate
+        if (firstLegalMove == emptyMove && std::get<0>(rtn) == emptyMove) {
+            rtn = std::make_pair(emptyMove, (board.checkers) ? MATE : DRAW);
+            return rtn;
+        }
+        
+        //If no cutoff was found by the previous loop, default to the first legal move in the list
+        if (std::get<0>(rtn) == emptyMove) {
+            rtn = std::make_pair(firstLegalMove, b);
         }
     }
 
-    const auto cornerIndex = board.findCorner_1D();
-    
     if (std::get<1>(rtn) <= alpha) {
         //Store rtn as upper bound
-        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::UPPER, 
-                    std::get<0>(rtn), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).fromSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).toSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).enPassantTarget), cornerIndex)
-                    ));
+        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::UPPER, std::get<0>(rtn)));
     } else if (std::get<1>(rtn) > alpha && std::get<1>(rtn) < beta) {
         //Should not happen if using null window, but if it does, store rtn as both upper and lower
-        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::EXACT, 
-                    std::get<0>(rtn), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).fromSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).toSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).enPassantTarget), cornerIndex)
-                    ));
+        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::EXACT, std::get<0>(rtn)));
     } else if (std::get<1>(rtn) >= beta ) {
         //Store rtn as lower bound
-        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::LOWER, 
-                    std::get<0>(rtn), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).fromSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).toSq), cornerIndex), 
-                        board.convertOuterBoardIndex(board.getSquareIndex(std::get<0>(rtn).enPassantTarget), cornerIndex)
-                    ));
+        boardCache->add(board, std::make_tuple(depth, std::get<1>(rtn), SearchBoundary::LOWER, std::get<0>(rtn)));
         if (prev != emptyMove) {
             //If no piece is being captured
-            if (std::get<0>(rtn).toSq && !std::get<0>(rtn).toSq->getPiece() && prev != emptyMove) {
-                counterMove[
-                    (pieceLookupTable.find(prev.fromPieceType)->second * INNER_BOARD_SIZE * INNER_BOARD_SIZE) 
-                    + previousToSquareIndex
-                ] = std::get<0>(rtn);
+            if (std::get<0>(rtn) != emptyMove && !isCapture(std::get<0>(rtn), board)) {
+                counterMove[previousCounterMoveIndex] = std::get<0>(rtn);
             }
         }
     }
     return rtn;
 }
 
+/**
+ * Searches the position reached by a move.
+ * In copy-make mode the child position is built in a copy of the board on this stack frame and simply discarded,
+ * otherwise the move is made on the board itself and unmade afterwards.
+ */
+std::pair<Move, int> AI::searchMove(const Move mv, const int alpha, const int beta, const int depth, Board& board) {
+    searchHistory.push(board.getCurrHash());
+    if (useCopyMake) {
+        Board child{board};
+        child.makeMove(mv);
+        const auto result = AlphaBeta(alpha, beta, depth, child);
+        searchHistory.pop();
+        return result;
+    }
+    const auto undo = board.makeMove(mv);
+    const auto result = AlphaBeta(alpha, beta, depth, board);
+    board.unmakeMove(mv, undo);
+    searchHistory.pop();
+    return result;
+}
+
 /**
  * Performs perft evaluation in parallel to a certain depth on a given board.
  * This is used primarily for checking the correctness of the chess engine,
@@ -623,38 +613,59 @@ std::tuple<Move, int, int, int, int> AI::AlphaBeta(int alpha, int beta, const in
  * fast move generation and tree traversal is based on fixed and deterministic parameters.
  */
 unsigned long long AI::perft(int depth, Board& board) {
-    auto moveList = board.moveGen.generateAll();
-    const auto moveListSize = moveList.size();
-
     assert(depth > 0);
 
+    //Leaf moves are counted without being generated
     if (depth == 1) {
-        return moveListSize;
+        return board.getMoveGen().countLegalMoves();
     }
 
+    auto moveList = board.getMoveGen().generateAll();
+    const auto moveListSize = moveList.size();
+
     unsigned long long nodeCount = 0;
 
-#pragma omp parallel firstprivate(board, moveList, moveListSize)
+    //Only the outermost call splits its moves between threads, nested calls already own their board
+    if (omp_get_level()) {
+        for (size_t i = 0; i < moveListSize; ++i) {
+            nodeCount += perftMove(moveList[i], depth - 1, board);
+        }
+        return nodeCount;
+    }
+
+#pragma omp parallel
     {
         Board b{board};
-        moveList = b.moveGen.generateAll();
 #pragma omp for reduction(+:nodeCount)
         for (size_t i = 0; i < moveListSize; ++i) {
-            b.makeMove(moveList[i]);
-            nodeCount += perft(depth - 1, b);
-            b.unmakeMove(moveList[i]);
+            nodeCount += perftMove(moveList[i], depth - 1, b);
         }
     }
     return nodeCount;
 }
 
+/**
+ * Counts the perft nodes below a move, either by copying the board or by making and unmaking the move.
+ */
+unsigned long long AI::perftMove(const Move mv, const int depth, Board& board) {
+    if (useCopyMake) {
+        Board child{board};
+        child.makeMove(mv);
+        return perft(depth, child);
+    }
+    const auto undo = board.makeMove(mv);
+    const auto nodeCount = perft(depth, board);
+    board.unmakeMove(mv, undo);
+    return nodeCount;
+}
+
 /**
  * Performs a divided perft output.
  * This is mainly used for debugging incorrect perft results as it will
  * show the breakdown of perft results based on individual moves at the root node.
  */
 unsigned long long AI::perftDivide(int depth, Board& board) {
-    auto moveList = board.moveGen.generateAll();
+    auto moveList = board.getMoveGen().generateAll();
     const auto moveListSize = moveList.size();
     
     if (!depth) {
@@ -663,128 +674,115 @@ unsigned long long AI::perftDivide(int depth, Board& board) {
     
     unsigned long long nodeCount = 0;
     for (size_t i = 0; i < moveListSize; ++i) {
-        board.makeMove(moveList[i]);
+        const auto undo = board.makeMove(moveList[i]);
         const auto perftResult = perft(depth - 1, board);
         std::cout << board.convertMoveToCoordText(moveList[i]) << ": " << perftResult << "\n";
         nodeCount += perftResult;
-        board.unmakeMove(moveList[i]);
+        board.unmakeMove(moveList[i], undo);
     }
     return nodeCount;
 }
 
 /**
- * Initializes the piece square tables for evaluation.
- * The tables are initially emplaced from white' perspective, and the copied and reversed for black.
+ * Returns a piece square table from the other player's perspective.
+ */
+AI::PieceSquareTable AI::mirrorTable(const PieceSquareTable& table) {
+    PieceSquareTable mirrored;
+    std::reverse_copy(std::begin(table), std::end(table), std::begin(mirrored));
+    return mirrored;
+}
+
+/**
+ * Initializes the piece square tables for evaluation, indexed by piece code.
+ * The tables are initially filled in from white's perspective, and then mirrored for black.
+ * The king table here is the middlegame one, the endgame tables are kept in kingEndGameTables.
  */
-std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>> AI::initializeMap() {
-    std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>> tempMap;
+std::array<AI::PieceSquareTable, NUM_SQUARE_STATES> AI::initializePieceSquareTables() {
+    std::array<PieceSquareTable, NUM_SQUARE_STATES> tables;
     
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::PAWN, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-              0,  0,  0,  0,  0,  0,  0,  0,
-             50, 50, 50, 50, 50, 50, 50, 50,
-             10, 10, 20, 40, 40, 20, 10, 10,
-              5,  5, 10, 30, 30, 10,  5,  5,
-              0,  0,  0, 25, 25,  0,  0,  0,
-              5, -5, 10, -5, -5,-10, -5,  5,
-              5, 10, 10,-25,-25, 10, 10, 50,
-              0,  0,  0,  0,  0,  0,  0,  0
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::BISHOP, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-            -20,-10,-10,-10,-10,-10,-10,-20,
-            -10,  0,  0,  0,  0,  0,  0,-10,
-            -10,  0,  5, 10, 10,  5,  0,-10,
-            -10,  5,  5, 10, 10,  5,  5,-10,
-            -10,  0, 10, 10, 10, 10,  0,-10,
-            -10, 10, 10, 10, 10, 10, 10,-10,
-            -10,  5,  0,  0,  0,  0,  5,-10,
-            -20,-10,-10,-10,-10,-10,-10,-20
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::KNIGHT, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-            -40,-30,-20,-20,-20,-20,-30,-40,
-            -30,-20,  0,  0,  0,  0,-20,-30,
-            -20,  0, 10, 15, 15, 10,  0,-20,
-            -20,  5, 15, 20, 20, 15,  5,-20,
-            -20,  0, 15, 20, 20, 15,  0,-20,
-            -20,  5, 10, 15, 15, 10,  5,-20,
-            -30,-20,  0,  5,  5,  0,-20, 30,
-            -40,-30,-20,-20,-20,-20,-30,-40
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::ROOK, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-              0,  0,  0,  0,  0,  0,  0,  0,
-              5, 10, 10, 10, 10, 10, 10,  5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-             -5,  0,  0,  0,  0,  0,  0, -5,
-              0,  0,  0,  5,  5,  0,  0,  0
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::KING, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-40,-40,-50,-50,-40,-40,-30,
-            -30,-30,-30,-40,-40,-30,-30,-30,
-            -30,-30,-30,-30,-30,-30,-30,-30,
-            -30,-30,-30,-30,-30,-30,-30,-30,
-             40, 40, 50,  0,  0, 30, 50, 40
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::KING, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-            -50,-40,-30,-20,-20,-30,-40,-50,
-            -30,-20,-10,  0,  0,-10,-20,-30,
-            -30,-10, 20, 30, 30, 20,-10,-30,
-            -30,-10, 30, 40, 40, 30,-10,-30,
-            -30,-10, 30, 40, 40, 30,-10,-30,
-            -30,-10, 20, 30, 30, 20,-10,-30,
-            -30,-30,  0,  0,  0,  0,-30,-30,
-            -50,-30,-30,-30,-30,-30,-30,-50
-        }}));
-    tempMap.emplace(std::make_pair(Piece(PieceTypes::QUEEN, Colour::WHITE), 
-        std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>{{
-             -20,-10,-10, -5, -5,-10,-10,-20,
-             -10,  0,  0,  0,  0,  0,  0,-10,
-             -10,  0,  5,  5,  5,  5,  0,-10,
-              -5,  0,  5,  5,  5,  5,  0, -5,
-               0,  0,  5,  5,  5,  5,  0, -5,
-             -10,  5,  5,  5,  5,  5,  0,-10,
-             -10,  0,  5,  0,  0,  0,  0,-10,
-             -20,-10,-10, -5, -5,-10,-10,-20
-        }}));
-        
-    for (size_t i = 0; i < 6; ++i) {
-        PieceTypes type;
-        switch(i) {
-            case 0:
-                type = PieceTypes::PAWN;
-                break;
-            case 1:
-                type = PieceTypes::BISHOP;
-                break;
-            case 2:
-                type = PieceTypes::KNIGHT;
-                break;
-            case 3:
-                type = PieceTypes::ROOK;
-                break;
-            case 4:
-                type = PieceTypes::KING;
-                break;
-            case 5:
-                type = PieceTypes::QUEEN;
-                break;
-        }
-        //Reverse piece square tables for black pieces
-        auto previousValue = tempMap.find(Piece(type, Colour::WHITE))->second;
-        std::reverse_copy(std::begin(previousValue), std::end(previousValue), std::begin(previousValue));
-        tempMap.emplace(std::make_pair(Piece(type, Colour::BLACK), previousValue));
+    tables[getPieceCode(PieceTypes::PAWN, Colour::WHITE)] = {{
+          0,  0,  0,  0,  0,  0,  0,  0,
+         50, 50, 50, 50, 50, 50, 50, 50,
+         10, 10, 20, 40, 40, 20, 10, 10,
+          5,  5, 10, 30, 30, 10,  5,  5,
+          0,  0,  0, 25, 25,  0,  0,  0,
+          5, -5, 10, -5, -5,-10, -5,  5,
+          5, 10, 10,-25,-25, 10, 10, 50,
+          0,  0,  0,  0,  0,  0,  0,  0
+    }};
+    tables[getPieceCode(PieceTypes::BISHOP, Colour::WHITE)] = {{
+        -20,-10,-10,-10,-10,-10,-10,-20,
+        -10,  0,  0,  0,  0,  0,  0,-10,
+        -10,  0,  5, 10, 10,  5,  0,-10,
+        -10,  5,  5, 10, 10,  5,  5,-10,
+        -10,  0, 10, 10, 10, 10,  0,-10,
+        -10, 10, 10, 10, 10, 10, 10,-10,
+        -10,  5,  0,  0,  0,  0,  5,-10,
+        -20,-10,-10,-10,-10,-10,-10,-20
+    }};
+    tables[getPieceCode(PieceTypes::KNIGHT, Colour::WHITE)] = {{
+        -40,-30,-20,-20,-20,-20,-30,-40,
+        -30,-20,  0,  0,  0,  0,-20,-30,
+        -20,  0, 10, 15, 15, 10,  0,-20,
+        -20,  5, 15, 20, 20, 15,  5,-20,
+        -20,  0, 15, 20, 20, 15,  0,-20,
+        -20,  5, 10, 15, 15, 10,  5,-20,
+        -30,-20,  0,  5,  5,  0,-20, 30,
+        -40,-30,-20,-20,-20,-20,-30,-40
+    }};
+    tables[getPieceCode(PieceTypes::ROOK, Colour::WHITE)] = {{
+          0,  0,  0,  0,  0,  0,  0,  0,
+          5, 10, 10, 10, 10, 10, 10,  5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+         -5,  0,  0,  0,  0,  0,  0, -5,
+          0,  0,  0,  5,  5,  0,  0,  0
+    }};
+    tables[getPieceCode(PieceTypes::KING, Colour::WHITE)] = {{
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-40,-40,-50,-50,-40,-40,-30,
+        -30,-30,-30,-40,-40,-30,-30,-30,
+        -30,-30,-30,-30,-30,-30,-30,-30,
+        -30,-30,-30,-30,-30,-30,-30,-30,
+         40, 40, 50,  0,  0, 30, 50, 40
+    }};
+    tables[getPieceCode(PieceTypes::QUEEN, Colour::WHITE)] = {{
+         -20,-10,-10, -5, -5,-10,-10,-20,
+         -10,  0,  0,  0,  0,  0,  0,-10,
+         -10,  0,  5,  5,  5,  5,  0,-10,
+          -5,  0,  5,  5,  5,  5,  0, -5,
+           0,  0,  5,  5,  5,  5,  0, -5,
+         -10,  5,  5,  5,  5,  5,  0,-10,
+         -10,  0,  5,  0,  0,  0,  0,-10,
+         -20,-10,-10, -5, -5,-10,-10,-20
+    }};
+    
+    for (const auto type : PIECE_TYPE_LIST) {
+        tables[getPieceCode(type, Colour::BLACK)] = mirrorTable(tables[getPieceCode(type, Colour::WHITE)]);
     }
-    return tempMap;
+    return tables;
+}
+
+/**
+ * Initializes the king piece square tables used in the endgame, indexed by colour.
+ * These favour a centralized king, unlike the middlegame table.
+ */
+std::array<AI::PieceSquareTable, 2> AI::initializeKingEndGameTables() {
+    const PieceSquareTable whiteTable{{
+        -50,-40,-30,-20,-20,-30,-40,-50,
+        -30,-20,-10,  0,  0,-10,-20,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 30, 40, 40, 30,-10,-30,
+        -30,-10, 20, 30, 30, 20,-10,-30,
+        -30,-30,  0,  0,  0,  0,-30,-30,
+        -50,-30,-30,-30,-30,-30,-30,-50
+    }};
+    return {{whiteTable, mirrorTable(whiteTable)}};
 }
 
 /**
@@ -794,42 +792,35 @@ std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SI
  * Lastly, a countermove heuristic is used.
  * Otherwise, the quiet moves are not in any particular order.
  */
-std::vector<Move> AI::orderMoveList(std::vector<Move>&& list, Board& board) {
-    assert([&]()->bool{
-        for (const auto& mv : list) {
-            if (!mv.fromSq || !mv.toSq) {
-                return false;
-            }
-        }
-        return true;
-    }());
+void AI::orderMoveList(MoveList& list, const Board& board) const {
+    assert(std::find(list.begin(), list.end(), emptyMove) == list.end());
 
     //Partition list with captures coming before quiet moves
     auto captureIt = std::partition(list.begin(), list.end(), 
-        [](const auto& mv){return mv.toPieceType != PieceTypes::UNKNOWN;});
+        [&board](const auto mv){return isCapture(mv, board);});
         
     //MVV-LVA sorting
     std::sort(list.begin(), captureIt, 
-        [this](const auto& first, const auto& second) {
-            if (first.toPieceType == second.toPieceType) {
-                return this->getPieceValue(first.fromPieceType) < this->getPieceValue(second.fromPieceType);
+        [this, &board](const auto first, const auto second) {
+            const auto firstVictim = getCapturedType(first, board);
+            const auto secondVictim = getCapturedType(second, board);
+            if (firstVictim == secondVictim) {
+                return this->getPieceValue(board.getPieceType(first.getFromSq())) 
+                    < this->getPieceValue(board.getPieceType(second.getFromSq()));
             }
-            return this->getPieceValue(first.toPieceType) > this->getPieceValue(second.toPieceType);
+            return this->getPieceValue(firstVictim) > this->getPieceValue(secondVictim);
         }
     );
 
     if (prev != emptyMove) {
-        assert(pieceLookupTable.find(prev.fromPieceType) != pieceLookupTable.end());
+        assert(previousCounterMoveIndex != -1);
 
-        for (const auto& mv : list) {
-            if (mv == counterMove[(pieceLookupTable.find(prev.fromPieceType)->second * INNER_BOARD_SIZE * INNER_BOARD_SIZE) 
-                    + previousToSquareIndex]) {
-                list.insert(captureIt + 1, mv);
-            }
+        //Move the counter move, if present, to the front of the quiet moves
+        const auto counterIt = std::find(captureIt, list.end(), counterMove[previousCounterMoveIndex]);
+        if (counterIt != list.end()) {
+            std::rotate(captureIt, counterIt, counterIt + 1);
         }
     }
-    
-    return list;
 }
 
 /**
@@ -874,29 +865,3 @@ void AI::benchmarkPerft() {
     std::cout << "Depth 4: " << ((perft(4, *gameBoard) == 3894594) ? "Passed" : "Failed") << "\n";
     std::cout << "Depth 5: " << ((perft(5, *gameBoard) == 164075551) ? "Passed" : "Failed") << "\n";
 }
-
-/**
- * This method is essential to the multithreaded search. Due to the nature of the search performing deep copies
- * of the current board for each thread; each thread has a separate board in a separate section of memory.
- * The moves generated contain pointers to the from and to squares, resulting in all generated moves only being
- * valid for a given board instance.
- * This method is used to translate the pointers based on board invariant conversion values to a new board.
- * These values are the index on the 8x8 board as to where the pointers point.
- * So a pointer to d7 would equal the value 11.
- * This simple translation allows moves to be consolidated and shared across threads, even when the memory they
- * referred to has been freed and is unusable.
- * This normally is somewhat of a hack I will admit, though I could not find a more elegant solution without
- * completely restructuring moves to not use pointers, which would require essentially a rewrite of the entire chess engine
- * and move validation calls.
- */
-void AI::translateMovePointers(Board& b, Move& mv, std::tuple<int, int, int> conversionOffsets) {
-    const auto cornerIndex = b.findCorner_1D();
-
-    mv.fromSq = (mv.fromSq) ? b.vectorTable[cornerIndex + ((std::get<0>(conversionOffsets) / INNER_BOARD_SIZE) 
-            * OUTER_BOARD_SIZE) + (std::get<0>(conversionOffsets) % INNER_BOARD_SIZE)].get() : nullptr;
-    mv.toSq = (mv.toSq) ? b.vectorTable[cornerIndex + ((std::get<1>(conversionOffsets) / INNER_BOARD_SIZE) 
-            * OUTER_BOARD_SIZE) + (std::get<1>(conversionOffsets) % INNER_BOARD_SIZE)].get() : nullptr;
-    mv.enPassantTarget = (mv.enPassantTarget) ? b.vectorTable[cornerIndex + ((std::get<2>(conversionOffsets) / INNER_BOARD_SIZE) 
-            * OUTER_BOARD_SIZE) + (std::get<2>(conversionOffsets) % INNER_BOARD_SIZE)].get() : nullptr;
-}
-
@@ -0,0 +1,328 @@
+/**
+* This is part of ChessPlusPlus, a C++14 Chess AI
+* Copyright (C) 2017 John Agapeyev
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <array>
+#include <cassert>
+#include "headers/bitboard.h"
+#include "headers/consts.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAS_PEXT
+#endif
+
+static constexpr int KNIGHT_DELTAS[] = {17, 15, 10, 6, -6, -10, -15, -17};
+
+/**
+ * Number of squares between a square and the edge of the board in a given direction.
+ */
+static constexpr int getSquaresToEdge(const int square, const int direction) {
+    const int north = INNER_BOARD_SIZE - 1 - getRank(square);
+    const int south = getRank(square);
+    const int east = INNER_BOARD_SIZE - 1 - getFile(square);
+    const int west = getFile(square);
+    const int distances[NUM_DIRECTIONS] = {north, south, east, west, 
+        (north < east) ? north : east, (north < west) ? north : west, 
+        (south < east) ? south : east, (south < west) ? south : west};
+    return distances[direction];
+}
+
+/**
+ * Builds the attack table of a piece that moves a single step along each delta.
+ * A step is discarded if it leaves the board or wraps around to the other side.
+ */
+static constexpr ConstTable<Bitboard> populateStepAttacks(const int *deltas, const int numDeltas) {
+    ConstTable<Bitboard> result{};
+    for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+        for (int i = 0; i < numDeltas; ++i) {
+            const int target = square + deltas[i];
+            const int fileDistance = getFile(target) - getFile(square);
+            if (target >= 0 && target < INNER_BOARD_SIZE * INNER_BOARD_SIZE 
+                    && fileDistance <= 2 && fileDistance >= -2) {
+                result[square] |= squareMask(target);
+            }
+        }
+    }
+    return result;
+}
+
+static constexpr ConstTable<ConstTable<Bitboard>, 2> populatePawnAttacks() {
+    ConstTable<ConstTable<Bitboard>, 2> result{};
+    for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+        const auto mask = squareMask(square);
+        result[0][square] = ((mask & ~FILE_A_MASK) << 7) | ((mask & ~FILE_H_MASK) << 9);
+        result[1][square] = ((mask & ~FILE_A_MASK) >> 9) | ((mask & ~FILE_H_MASK) >> 7);
+    }
+    return result;
+}
+
+/**
+ * Builds the unobstructed ray from every square in every direction, up to the edge of the board.
+ */
+static constexpr ConstTable<ConstTable<Bitboard>, NUM_DIRECTIONS> populateRays() {
+    ConstTable<ConstTable<Bitboard>, NUM_DIRECTIONS> result{};
+    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+        for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+            int target = square;
+            for (int i = 0; i < getSquaresToEdge(square, dir); ++i) {
+                target += DIRECTION_DELTAS[dir];
+                result[dir][square] |= squareMask(target);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Walks every ray from every square, recording the squares passed over on the way to each target.
+ * If isLine is set, the entire line through both squares is recorded instead.
+ */
+static constexpr ConstTable<ConstTable<Bitboard>> populateAlignedSquares(const bool isLine) {
+    ConstTable<ConstTable<Bitboard>> result{};
+    for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            //Directions come in pairs, so the opposite of each one is its neighbour
+            const int opposite = dir ^ ((dir < 4) ? 1 : 3);
+            const auto line = squareMask(square) | RAYS[dir][square] | RAYS[opposite][square];
+            Bitboard between = 0;
+            int target = square;
+            for (int i = 0; i < getSquaresToEdge(square, dir); ++i) {
+                target += DIRECTION_DELTAS[dir];
+                result[square][target] = (isLine) ? line : between;
+                between |= squareMask(target);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Fills in the delta table from the square based attack tables.
+ * Every square pair with the same rank and file offset shares a delta index, so overlapping entries always agree.
+ */
+static constexpr ConstTable<DeltaAttack, NUM_SQUARE_DELTAS> populateDeltaAttacks() {
+    ConstTable<DeltaAttack, NUM_SQUARE_DELTAS> result{};
+    for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+        for (int target = 0; target < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++target) {
+            if (KNIGHT_ATTACKS[square] & squareMask(target)) {
+                result[getDeltaIndex(square, target)].pieceTypes |= getPieceTypeBit(PieceTypes::KNIGHT);
+            }
+            if (KING_ATTACKS[square] & squareMask(target)) {
+                result[getDeltaIndex(square, target)].pieceTypes |= getPieceTypeBit(PieceTypes::KING);
+            }
+        }
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            const auto slider = (dir < 4) ? PieceTypes::ROOK : PieceTypes::BISHOP;
+            int target = square;
+            for (int i = 0; i < getSquaresToEdge(square, dir); ++i) {
+                target += DIRECTION_DELTAS[dir];
+                auto& entry = result[getDeltaIndex(square, target)];
+                entry.pieceTypes |= getPieceTypeBit(slider) | getPieceTypeBit(PieceTypes::QUEEN);
+                entry.step = DIRECTION_DELTAS[dir];
+            }
+        }
+    }
+    return result;
+}
+
+constexpr ConstTable<ConstTable<Bitboard>, 2> PAWN_ATTACKS = populatePawnAttacks();
+constexpr ConstTable<Bitboard> KNIGHT_ATTACKS = populateStepAttacks(KNIGHT_DELTAS, 8);
+constexpr ConstTable<Bitboard> KING_ATTACKS = populateStepAttacks(DIRECTION_DELTAS, NUM_DIRECTIONS);
+constexpr ConstTable<ConstTable<Bitboard>, NUM_DIRECTIONS> RAYS = populateRays();
+constexpr ConstTable<ConstTable<Bitboard>> BETWEEN = populateAlignedSquares(false);
+constexpr ConstTable<ConstTable<Bitboard>> LINE = populateAlignedSquares(true);
+constexpr ConstTable<DeltaAttack, NUM_SQUARE_DELTAS> DELTA_ATTACKS = populateDeltaAttacks();
+
+/**
+ * Returns the attacks along the given range of directions from a square.
+ * Each ray is cut off at its first occupied square by removing the ray that continues past it.
+ * The blocking square is included in the result.
+ * This is only used to fill the slider lookup tables at startup.
+ */
+static Bitboard getRayAttacks(const int square, const Bitboard occupancy, const int firstDirection, const int lastDirection) {
+    Bitboard result = 0;
+    for (int dir = firstDirection; dir < lastDirection; ++dir) {
+        auto attacks = RAYS[dir][square];
+        const auto blockers = attacks & occupancy;
+        if (blockers) {
+            //Positive deltas walk towards higher squares, so the nearest blocker is the lowest one
+            const auto blocker = (DIRECTION_DELTAS[dir] > 0) ? getLowestSquare(blockers) : getHighestSquare(blockers);
+            attacks ^= RAYS[dir][blocker];
+        }
+        result |= attacks;
+    }
+    return result;
+}
+
+/**
+ * Lookup data for the attacks of one slider on one square.
+ * The mask holds the squares whose occupancy can shorten a ray, which excludes the edge at the end of each ray.
+ * The masked occupancy is turned into an index into that square's slice of the attack table, 
+ * either by multiplying with the magic number and keeping the top bits, or by a PEXT instruction.
+ */
+struct SliderMagic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard *attacks;
+    unsigned int shift;
+};
+
+/*
+ * Table sizes are the sum over all squares of 2 to the power of the number of relevant occupancy bits.
+ */
+static Bitboard rookAttackTable[0x19000];
+static Bitboard bishopAttackTable[0x1480];
+static std::array<SliderMagic, INNER_BOARD_SIZE * INNER_BOARD_SIZE> rookMagics;
+static std::array<SliderMagic, INNER_BOARD_SIZE * INNER_BOARD_SIZE> bishopMagics;
+
+#ifdef HAS_PEXT
+static bool checkBmi2Support() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+}
+
+static const bool usePext = checkBmi2Support();
+
+__attribute__((target("bmi2"))) static unsigned int getPextIndex(const Bitboard occupancy, const Bitboard mask) {
+    return _pext_u64(occupancy, mask);
+}
+#else
+static const bool usePext = false;
+
+static unsigned int getPextIndex(const Bitboard, const Bitboard) {
+    return 0;
+}
+#endif
+
+static inline unsigned int getMagicIndex(const SliderMagic& entry, const Bitboard occupancy) {
+    return ((occupancy & entry.mask) * entry.magic) >> entry.shift;
+}
+
+static inline unsigned int getSliderIndex(const SliderMagic& entry, const Bitboard occupancy) {
+    return (usePext) ? getPextIndex(occupancy, entry.mask) : getMagicIndex(entry, occupancy);
+}
+
+/**
+ * Xorshift generator used for the magic number search.
+ * It is seeded with fixed values so the same magics are found on every run.
+ */
+class MagicRandom {
+    uint64_t state;
+    
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ull;
+    }
+    
+public:
+    MagicRandom(const uint64_t seed) : state(seed) {}
+    
+    /**
+     * Magics with few set bits tend to work, so three random numbers are combined to thin out the bits.
+     */
+    uint64_t sparse() {
+        return next() & next() & next();
+    }
+};
+
+/**
+ * Fills the lookup table for one slider type, searching for a magic number on each square
+ * that maps every relevant occupancy to its attacks without any harmful collisions.
+ * When PEXT is available the index is the occupancy bits themselves, so no search is needed.
+ */
+static void initSliderMagics(std::array<SliderMagic, INNER_BOARD_SIZE * INNER_BOARD_SIZE>& magics, 
+        Bitboard *table, const int firstDirection, const int lastDirection) {
+    //Seeds chosen per rank so that the search finishes quickly
+    static constexpr uint64_t seeds[INNER_BOARD_SIZE] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+    
+    std::array<Bitboard, 4096> occupancies;
+    std::array<Bitboard, 4096> reference;
+    std::array<int, 4096> attempt{};
+    int attemptCount = 0;
+    
+    for (int square = 0; square < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++square) {
+        const auto edges = ((RANK_1_MASK | RANK_8_MASK) & ~(RANK_1_MASK << (8 * getRank(square)))) 
+            | ((FILE_A_MASK | FILE_H_MASK) & ~(FILE_A_MASK << getFile(square)));
+        
+        auto& entry = magics[square];
+        entry.mask = getRayAttacks(square, 0, firstDirection, lastDirection) & ~edges;
+        entry.shift = 64 - popCount(entry.mask);
+        entry.attacks = (square == 0) ? table : magics[square - 1].attacks + (1u << (64 - magics[square - 1].shift));
+        
+        //Enumerate every subset of the mask using the Carry-Rippler trick
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            reference[size] = getRayAttacks(square, subset, firstDirection, lastDirection);
+            if (usePext) {
+                entry.attacks[getPextIndex(subset, entry.mask)] = reference[size];
+            }
+            ++size;
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset);
+        
+        if (usePext) {
+            continue;
+        }
+        
+        MagicRandom rng{seeds[getRank(square)]};
+        for (int i = 0; i < size;) {
+            do {
+                entry.magic = rng.sparse();
+            } while (popCount((entry.magic * entry.mask) >> 56) < 6);
+            
+            /*
+             * Attempt numbers mark which table entries were written by the current candidate,
+             * so the table never needs to be cleared between candidates.
+             */
+            ++attemptCount;
+            for (i = 0; i < size; ++i) {
+                const auto index = getMagicIndex(entry, occupancies[i]);
+                if (attempt[index] < attemptCount) {
+                    attempt[index] = attemptCount;
+                    entry.attacks[index] = reference[i];
+                } else if (entry.attacks[index] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static bool initSliderAttacks() {
+    initSliderMagics(rookMagics, rookAttackTable, 0, 4);
+    initSliderMagics(bishopMagics, bishopAttackTable, 4, NUM_DIRECTIONS);
+    return true;
+}
+
+static const bool slidersInitialized = initSliderAttacks();
+
+Bitboard getBishopAttacks(const int square, const Bitboard occupancy) {
+    assert(slidersInitialized);
+    const auto& entry = bishopMagics[square];
+    return entry.attacks[getSliderIndex(entry, occupancy)];
+}
+
+Bitboard getRookAttacks(const int square, const Bitboard occupancy) {
+    assert(slidersInitialized);
+    const auto& entry = rookMagics[square];
+    return entry.attacks[getSliderIndex(entry, occupancy)];
+}
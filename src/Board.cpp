@@ -23,439 +23,170 @@
 #include <regex>
 #include <cassert>
 #include <string>
-#include <omp.h>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
 #include "headers/board.h"
-#include "headers/square.h"
 #include "headers/consts.h"
 #include "headers/enums.h"
 #include "headers/move.h"
+#include "headers/bitboard.h"
+#include "headers/history.h"
 
-/*
- * Offset = 98 - (15 * i) + (j + 1)
- * IMPORTANT:
- * Positive x: (30 * ((x + 7) / 15)) - x
- * Negative x: -((30 * ((abs(x) + 7) / 15)) - abs(x))
- */
- 
 /**
- * Board constructor performs a deep copy of the initial board state.
- * It also initializes the repitionList and the current board hash.
+ * Board constructor fills the bitboards and mailbox from the initial board state.
+ * It also computes the current board hash.
  */
 Board::Board() {
-    for (int i = 0; i < OUTER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < OUTER_BOARD_SIZE; ++j) {
-            if (i >= 0 && i <= 7) {
-                if (j >= 0 && j <= 7) {
-                    vectorTable[(i * OUTER_BOARD_SIZE) + j] = std::make_unique<Square>(*INIT_BOARD[i][j]);
-                    vectorTable[(i * OUTER_BOARD_SIZE) + j]->setOffset(genOffset(i, j));
-                } else {
-                    vectorTable[(i * OUTER_BOARD_SIZE) + j] = std::make_unique<Square>(genOffset(i, j));
-                }
-            } else {
-                vectorTable[(i * OUTER_BOARD_SIZE) + j] = std::make_unique<Square>(genOffset(i, j));
-            }
+    mailbox.fill(EMPTY_SQUARE);
+    for (int i = 0; i < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++i) {
+        if (INIT_BOARD[i] != EMPTY_SQUARE) {
+            placePiece(i, PIECE_TYPE_LIST[INIT_BOARD[i] % 6], (INIT_BOARD[i] < 6) ? Colour::WHITE : Colour::BLACK);
         }
     }
     
-    for (size_t i = 0; i < repititionList.size(); ++i) {
-        repititionList[i] = i;
-    }
+    currHash = 0;
     currHash = std::hash<Board>()(*this);
 }
 
 /**
- * Copy constructor performs a deep board copy of another board.
- * This is not used outside of threading specific board creation.
+ * Returns the type of the piece on a given square, or UNKNOWN if it is empty.
  */
-Board::Board(const Board& b) : moveGen(this), currentGameState(b.currentGameState), castleRights(b.castleRights), 
-        blackInCheck(b.blackInCheck), whiteInCheck(b.whiteInCheck), isWhiteTurn(b.isWhiteTurn), enPassantActive(b.enPassantActive), 
-        halfMoveClock(b.halfMoveClock), moveCounter(b.moveCounter), 
-        currHash(b.currHash), repititionList(b.repititionList), cornerCache(b.cornerCache) {
-
-    for (int i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        vectorTable[i] = std::make_unique<Square>(*b.vectorTable[i]);
-    }
-
-    if (b.enPassantTarget) {
-        const auto targetIndex = const_cast<Board&>(b).getSquareIndex(b.enPassantTarget);
-        assert(targetIndex != -1);
-        enPassantTarget = vectorTable[targetIndex].get();
-    } else {
-        enPassantTarget = nullptr;
-    }
-
-    assert(checkBoardValidity());
+PieceTypes Board::getPieceType(const int square) const {
+    const auto code = mailbox[square];
+    return (code == EMPTY_SQUARE) ? PieceTypes::UNKNOWN : PIECE_TYPE_LIST[code % 6];
 }
 
 /**
- * Deep copy copy assignment operator.
- * Same as above, not used outside of threading purposes.
+ * Returns the colour of the piece on a given square, or UNKNOWN if it is empty.
  */
-Board& Board::operator=(const Board& b) {
-    moveGen = std::move(MoveGenerator{this});
-    currentGameState = b.currentGameState;
-    castleRights = b.castleRights;
-    blackInCheck = b.blackInCheck;
-    whiteInCheck = b.whiteInCheck;
-    isWhiteTurn = b.isWhiteTurn;
-    enPassantActive = b.enPassantActive;
-    if (b.enPassantTarget) {
-        const auto targetIndex = const_cast<Board&>(b).getSquareIndex(b.enPassantTarget);
-        assert(targetIndex != -1);
-        enPassantTarget = vectorTable[targetIndex].get();
-    } else {
-        enPassantTarget = nullptr;
-    }
-    halfMoveClock = b.halfMoveClock;
-    moveCounter = b.moveCounter;
-    currHash = b.currHash;
-    repititionList = b.repititionList;
-    cornerCache = b.cornerCache;
-    for (int i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        vectorTable[i] = std::make_unique<Square>(*b.vectorTable[i]);
+Colour Board::getPieceColour(const int square) const {
+    const auto code = mailbox[square];
+    if (code == EMPTY_SQUARE) {
+        return Colour::UNKNOWN;
     }
-    assert(checkBoardValidity());
-    return *this;
-}
-
-/**
- * Due to the nature of the board shifting around inside of the array, this function returns
- * the 2D coordinates of the corner of the board.
- */
-std::pair<int, int> Board::findCorner() {
-    if (cornerCache != -1) {
-        return {cornerCache / OUTER_BOARD_SIZE, cornerCache % OUTER_BOARD_SIZE};
-    }
-    for (size_t i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        if (!vectorTable[i]->checkSentinel()) {
-            cornerCache = i;
-            return {i / OUTER_BOARD_SIZE, i % OUTER_BOARD_SIZE};
-        }
-    }
-    return {-1, -1};
-}
-
-/**
- * Same as above, but returns a 1D index of the board corner.
- */
-int Board::findCorner_1D() {
-    if (cornerCache != -1) {
-        return cornerCache;
-    }
-    for (size_t i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        if (!vectorTable[i]->checkSentinel()) {
-            cornerCache = i;
-            return i; 
-        }
-    }
-    return -1;
+    return (code < 6) ? Colour::WHITE : Colour::BLACK;
 }
 
 /**
  * Main output method for displaying the board.
  */
 void Board::printBoardState() const {
-#ifdef NDEBUG
-    const auto range = INNER_BOARD_SIZE;
-    std::vector<Square *> outputTable;
-    for (size_t i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        const auto pc = vectorTable[i]->getPiece();
-        if (!(pc && pc->getColour() == Colour::UNKNOWN && pc->getType() == PieceTypes::UNKNOWN)) {
-            outputTable.push_back(vectorTable[i].get());
-        }
-    }
-#else
-    const auto range = OUTER_BOARD_SIZE;
-#endif
-    for (auto i = 0; i < range; ++i) {
-#ifdef NDEBUG
+    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
         std::cout << "  ";
-#endif
-#pragma omp parallel for schedule(static)
-        for (int j = 0; j < range; ++j) {
-#ifndef NDEBUG
-            std::cout << "--------";
-#else
+        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
             std::cout << "---";
-#endif
         }
-
-#ifndef NDEBUG
-        std::cout << "-\n|";
-        std::for_each(vectorTable.cbegin() + (i * range), vectorTable.cbegin() + ((i + 1) * range), 
-                [](const auto& sq){std::cout << *sq << '|';});
-#else
         std::cout << "-\n" << (INNER_BOARD_SIZE - i) << " |";
-        std::for_each(outputTable.cbegin() + (i * range), outputTable.cbegin() + ((i + 1) * range), 
-                [](const auto& sq){std::cout << *sq << '|';});
-#endif
+        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
+            const auto square = makeSquare(INNER_BOARD_SIZE - 1 - i, j);
+            const auto colour = getPieceColour(square);
+            if (colour == Colour::UNKNOWN) {
+                std::cout << "  ";
+            } else {
+                std::cout << static_cast<char>(colour) << static_cast<char>(getPieceType(square));
+            }
+            std::cout << '|';
+        }
         std::cout << "\n";
     }
-#ifdef NDEBUG
     std::cout << "  ";
-#endif
-
-    for (int k = 0; k < range; ++k) {
-#ifndef NDEBUG
-        std::cout << "--------";
-#else
+    for (int k = 0; k < INNER_BOARD_SIZE; ++k) {
         std::cout << "---";
-#endif
     }
     std::cout << "-\n";
     
-#ifdef NDEBUG
     std::cout << "    ";
-    for (int k = 0; k < range; ++k) {
+    for (int k = 0; k < INNER_BOARD_SIZE; ++k) {
         std::cout << std::left << std::setw(3) << static_cast<char>('a' + k);
     }
     std::cout << "\n";
-#endif
-}
-
-/**
- * Shifts the board horizontally by a given count.
- */
-void Board::shiftHorizontal(const int count) {
-    if (!count) {
-        return;
-    }
-    auto startCoords = findCorner();
-    
-    assert(!(startCoords.second + count < 0 
-        || startCoords.second + count + INNER_BOARD_SIZE - 1 > OUTER_BOARD_SIZE));
-
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            int col = INNER_BOARD_SIZE - 1 - i + ((count <= 0) * ((2 * i) - (INNER_BOARD_SIZE - 1)));
-            int row = INNER_BOARD_SIZE - 1 - j + ((count <= 0) * ((2 * j) - (INNER_BOARD_SIZE - 1)));
-            
-            std::swap(
-                vectorTable[
-                (startCoords.first * OUTER_BOARD_SIZE) 
-                    + startCoords.second + (col * OUTER_BOARD_SIZE) + row]
-                ,
-                vectorTable[
-                count + (startCoords.first * OUTER_BOARD_SIZE) 
-                    + startCoords.second + (col * OUTER_BOARD_SIZE) + row]
-            );
-        }
-    }
-}
-
-/**
- * Shifts the board vertically by a given count.
- */
-void Board::shiftVertical(const int count) {
-    if (!count) {
-        return;
-    }
-    auto startCoords = findCorner();
-    
-    assert(!(startCoords.first + count < 0 
-        || startCoords.first + count + INNER_BOARD_SIZE - 1 > OUTER_BOARD_SIZE));
-    
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            int col = INNER_BOARD_SIZE - 1 - i + ((count <= 0) * ((2 * i) - (INNER_BOARD_SIZE - 1)));
-            int row = INNER_BOARD_SIZE - 1 - j + ((count <= 0) * ((2 * j) - (INNER_BOARD_SIZE - 1)));
-            
-            std::swap(
-                vectorTable[
-                (startCoords.first * OUTER_BOARD_SIZE) 
-                    + startCoords.second + (col * OUTER_BOARD_SIZE) + row]
-                ,
-                vectorTable[
-                (count * OUTER_BOARD_SIZE) 
-                    + (startCoords.first * OUTER_BOARD_SIZE) 
-                    + startCoords.second + (col * OUTER_BOARD_SIZE) + row]
-            );
-        }
-    }
-}
-
-/**
- * The nature of the board requires that the current square a piece is moving
- * from has the square offset of 0, which is equal to 7,7 on the 15x15 board.
- * This method calls the above 2 shift calls to shift a given coordinate square to the
- * center of the board.
- */
-void Board::shiftBoard(const int col, const int row) {
-    const auto startCoords = findCorner();
-    const auto colDiff = ZERO_LOCATION.first - (startCoords.second + col);
-    const auto rowDiff = ZERO_LOCATION.second - (startCoords.first + row);
-    shiftHorizontal(colDiff);
-    cornerCache = -1; //Invalidate corner cache after shifting the board
-    shiftVertical(rowDiff);
-    cornerCache = -1; //Invalidate corner cache after shifting the board
-
-    for (int i = 0; i < OUTER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < OUTER_BOARD_SIZE; ++j) {
-            vectorTable[(i* OUTER_BOARD_SIZE) + j]->setOffset(genOffset(i, j));
-        }
-    }
 }
 
 /**
  * Takes a given user input and performs the move it indicates.
  * This method is only used when interacting with a user.
  */
-bool Board::makeMove(std::string& input) {
+bool Board::makeMove(std::string& input, PositionHistory& history) {
     assert(checkBoardValidity());
-    auto mv = moveGen.createMove(input);
-    
-    shiftBoard(input[0], INNER_BOARD_SIZE - 1 - input[1]);
+    auto mv = getMoveGen().createMove(input);
     
-    if (!moveGen.validateMove(mv, false)) {
+    if (!getMoveGen().validateMove(mv, false)) {
         return false;
     }
     
-    mv.halfMoveClock = halfMoveClock;
-    mv.moveCounter = moveCounter;
-    
-    ++halfMoveClock;
-    
-    const auto cornerIndex = findCorner_1D();
-    const auto diff = mv.toSq->getOffset() - mv.fromSq->getOffset();
-    
-    const auto distToFromSquare = getSquareIndex(mv.fromSq);
-    const auto distToEndSquare = getSquareIndex(mv.toSq);
-
-    assert(distToFromSquare != -1);
-    assert(distToEndSquare != -1);
-
-    captureEnPassant(mv, diff, distToEndSquare);
-
-    if (enPassantActive) {
-        const auto distToEnPassantTarget = getSquareIndex(enPassantTarget);
-        assert(distToEnPassantTarget != -1);
-                
-        //xor out en passant file
-        hashEnPassantFile(convertOuterBoardIndex(distToEnPassantTarget, cornerIndex) % INNER_BOARD_SIZE);
+    if (mv.isPromotion()) {
+        mv = Move(mv.getFromSq(), mv.getToSq(), Move::PROMOTION, 
+                static_cast<PieceTypes>(promptPromotionType().front()));
     }
     
-    mv.enPassantActive = enPassantActive;
-    mv.enPassantTarget = enPassantTarget;
-    
-    enPassantActive = false;
-    enPassantTarget = nullptr;
-
-    addEnPassantTarget(mv, diff, input[0], distToEndSquare);
-
-    performCastling(mv, diff, distToFromSquare);
-    
-    disableCastling(mv);
-
-    promotePawn(mv, distToEndSquare, false);
-    
-    // If moving to an occupied square, capture the piece
-    if (mv.toSq->getPiece()) {
-        mv.toSq->setPiece(nullptr);
-        halfMoveClock = 0;
-        hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.toPieceType, mv.toPieceColour);
-    }
-    //xor out from piece at old square
-    hashPieceChange(convertOuterBoardIndex(distToFromSquare, cornerIndex), (mv.promotionMade) ? PieceTypes::PAWN : mv.fromPieceType, mv.fromPieceColour);
-
-    //xor in from piece at new square
-    hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.fromPieceType, mv.fromPieceColour);
-
-    std::swap(*mv.fromSq, *mv.toSq);
-    swapOffsets(mv);
-    isWhiteTurn = !isWhiteTurn;
-    
-    //hash the change in turn
-    hashTurnChange();
-
-    moveCounter += isWhiteTurn;
-    
-    updateCheckStatus();
-    
-    std::rotate(repititionList.begin(), repititionList.begin() + 1, repititionList.end());
-    repititionList[repititionList.size() - 1] = currHash;
-
-    detectGameEnd();
-
-    assert(checkBoardValidity());
+    history.push(currHash);
+    makeMove(mv);
+    detectGameEnd(history);
     return true;
 }
 
 /**
  * This method makes a move provided to it.
- * In contrast to the above method, this is only ever called from the AI side
- * of things.
- * This separation of user and automated move making is done for small tweaks related to
- * movement such as whether to prompt the user or not for promotion types, etc.
+ * The move must be legal for the current position.
+ * The irreversible state of the position is returned so that the caller
+ * can later pass it to unmakeMove to restore it.
  */
-bool Board::makeMove(Move& mv) {
+UndoInfo Board::makeMove(const Move mv) {
     assert(checkBoardValidity());
-    assert(mv.fromSq && mv.toSq);
-    
-    const auto oldFromDist = getSquareIndex(mv.fromSq);
-    assert(oldFromDist != -1);
-    const auto cornerCoords = findCorner_1D();
-    assert(cornerCoords != -1);
-
-    const std::pair<int, int> shiftCoords{(oldFromDist - cornerCoords) / OUTER_BOARD_SIZE, 
-        (oldFromDist - cornerCoords) % OUTER_BOARD_SIZE};
-
-    assert(shiftCoords.first != -1);
-    assert(shiftCoords.second != -1);
-    shiftBoard(shiftCoords.second, shiftCoords.first);
-
-    assert(moveGen.validateMove(mv, false));
-
-    mv.halfMoveClock = halfMoveClock;
-    mv.moveCounter = moveCounter;
+    assert(getMoveGen().validateMove(mv, false));
+    
+    const auto fromSq = mv.getFromSq();
+    const auto toSq = mv.getToSq();
+    const auto movingColour = (isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
+    const auto movingType = getPieceType(fromSq);
+
+    UndoInfo undo;
+    undo.hash = currHash;
+    undo.capturedType = (mv.isEnPassant()) ? PieceTypes::PAWN : getPieceType(toSq);
+    undo.castleRights = castleRights;
+    undo.enPassantActive = enPassantActive;
+    undo.enPassantTarget = enPassantTarget;
+    undo.halfMoveClock = halfMoveClock;
+    undo.moveCounter = moveCounter;
+    undo.checkers = checkers;
 
     ++halfMoveClock;
     
-    const auto cornerIndex = findCorner_1D();
-    const auto diff = mv.toSq->getOffset() - mv.fromSq->getOffset();
-    
-    const auto distToFromSquare = getSquareIndex(mv.fromSq);
-    const auto distToEndSquare = getSquareIndex(mv.toSq);
-
-    assert(distToFromSquare != -1);
-    assert(distToEndSquare != -1);
-
-    captureEnPassant(mv, diff, distToEndSquare);
-    
     if (enPassantActive) {
-        const auto distToEnPassantTarget = getSquareIndex(enPassantTarget);
-        assert(distToEnPassantTarget != -1);
-                
         //xor out en passant file
-        hashEnPassantFile(convertOuterBoardIndex(distToEnPassantTarget, cornerIndex) % INNER_BOARD_SIZE);
+        hashEnPassantFile(getFile(enPassantTarget));
     }
-
-    mv.enPassantActive = enPassantActive;
-    mv.enPassantTarget = enPassantTarget;
     
     enPassantActive = false;
-    enPassantTarget = nullptr;
-
-    addEnPassantTarget(mv, diff, shiftCoords.second, distToEndSquare);
-
-    performCastling(mv, diff, distToFromSquare);
+    enPassantTarget = -1;
     
-    disableCastling(mv);
-
-    promotePawn(mv, distToEndSquare, true);
+    if (mv.isEnPassant()) {
+        //The captured pawn sits directly behind the target square
+        removePiece(toSq + (isWhiteTurn ? -INNER_BOARD_SIZE : INNER_BOARD_SIZE), 
+                PieceTypes::PAWN, getOppositeColour(movingColour));
+    } else if (undo.capturedType != PieceTypes::UNKNOWN) {
+        removePiece(toSq, undo.capturedType, getOppositeColour(movingColour));
+    }
     
-    // If moving to an occupied square, capture the piece
-    if (mv.toSq->getPiece()) {
-        mv.toSq->setPiece(nullptr);
+    if (undo.capturedType != PieceTypes::UNKNOWN) {
         halfMoveClock = 0;
-        hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.toPieceType, mv.toPieceColour);
     }
-    //xor out from piece at old square
-    hashPieceChange(convertOuterBoardIndex(distToFromSquare, cornerIndex), (mv.promotionMade) ? PieceTypes::PAWN: mv.fromPieceType, mv.fromPieceColour);
-    //xor in from piece at new square
-    hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.fromPieceType, mv.fromPieceColour);
+    
+    removePiece(fromSq, movingType, movingColour);
+    placePiece(toSq, (mv.isPromotion()) ? mv.getPromotionType() : movingType, movingColour);
+    
+    if (movingType == PieceTypes::PAWN) {
+        halfMoveClock = 0;
+        addEnPassantTarget(mv, movingColour);
+    }
+    
+    if (mv.isCastle()) {
+        performCastling(mv, movingColour, false);
+    }
+    
+    disableCastling(mv);
 
-    std::swap(*mv.fromSq, *mv.toSq);
-    swapOffsets(mv);
     isWhiteTurn = !isWhiteTurn;
     
     //hash the change in turn
@@ -465,127 +196,50 @@ bool Board::makeMove(Move& mv) {
     
     updateCheckStatus();
     
-    std::rotate(repititionList.begin(), repititionList.begin() + 1, repititionList.end());
-    repititionList[repititionList.size() - 1] = currHash;
-    
     assert(checkBoardValidity());
-    return true;
+    return undo;
 }
 
 /**
  * Unmakes a given move for the current board.
  * This is only ever called by the chess engine during tree traversal.
  * If the move provided is invalid or has not been immeditely made previously, 
- * the behaviour is undefined.
+ * or the undo state is not the one returned when it was made, the behaviour is undefined.
  */
-void Board::unmakeMove(const Move& mv) {
+void Board::unmakeMove(const Move mv, const UndoInfo& undo) {
     assert(checkBoardValidity());
     
-    const auto distToFromSquare = getSquareIndex(mv.fromSq);
-    const auto distToEndSquare = getSquareIndex(mv.toSq);
-
-    assert(distToFromSquare != -1 && distToEndSquare != -1);
-                
-    auto distToOldTarget = 0;
-    
-    if (enPassantTarget) {
-        distToOldTarget = getSquareIndex(enPassantTarget);
-        assert(distToOldTarget != -1);
-    }
-    const auto cornerIndex = findCorner_1D();
-    const auto diff = mv.toSq->getOffset() - mv.fromSq->getOffset();
-
-    std::swap(*mv.fromSq, *mv.toSq);
-    swapOffsets(mv);
     isWhiteTurn = !isWhiteTurn;
     
-    //hash the change in turn
-    hashTurnChange();
-    
-    //xor out from piece at old square
-    hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.fromPieceType, mv.fromPieceColour);
-
-    if (mv.promotionMade) {
-        mv.fromSq->setPiece({PieceTypes::PAWN, mv.fromPieceColour});
-        //xor in from piece at new square
-        hashPieceChange(convertOuterBoardIndex(distToFromSquare, cornerIndex), PieceTypes::PAWN, mv.fromPieceColour);
-    } else {
-        //xor in from piece at new square
-        hashPieceChange(convertOuterBoardIndex(distToFromSquare, cornerIndex), mv.fromPieceType, mv.fromPieceColour);
-    }
-        
-    if (mv.captureMade) {
-        mv.toSq->setPiece({mv.toPieceType, mv.toPieceColour});
-        hashPieceChange(convertOuterBoardIndex(distToEndSquare, cornerIndex), mv.toPieceType, mv.toPieceColour);
-    }
+    const auto fromSq = mv.getFromSq();
+    const auto toSq = mv.getToSq();
+    const auto movingColour = (isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
     
-    if (enPassantActive) {
-        //Hash out the current file
-        hashEnPassantFile((convertOuterBoardIndex(distToOldTarget, cornerIndex) % INNER_BOARD_SIZE));
-    }
+    const auto movedType = getPieceType(toSq);
     
-    if (mv.enPassantTarget) {
-        //Hash in the previous file num
-        const auto distToCurrTarget = getSquareIndex(mv.enPassantTarget);
-        assert(distToCurrTarget != -1);
-        const auto fileNum = convertOuterBoardIndex(distToCurrTarget, cornerIndex) % INNER_BOARD_SIZE;
-        
-        hashEnPassantFile(fileNum);
-    }
+    removePiece(toSq, movedType, movingColour);
+    placePiece(fromSq, (mv.isPromotion()) ? PieceTypes::PAWN : movedType, movingColour);
     
-    //En passant Capture was made.
-    if (mv.enPassantActive 
-            && mv.enPassantTarget 
-            && mv.fromPieceType == PieceTypes::PAWN 
-            && (diff % OUTER_BOARD_SIZE) 
-            && !mv.toSq->getPiece()
-            && mv.toSq->getOffset() == mv.enPassantTarget->getOffset()) {
-                
-        //Inner board index to en passant capture square
-        const auto enPassantCaptureIndex = distToFromSquare + diff 
-            - OUTER_BOARD_SIZE + (30 * (diff < 0));
-        
-        //Calculate the square containing the captured pawn and put it back
-        const auto capturedColour = (mv.fromPieceColour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
-        vectorTable[enPassantCaptureIndex]->setPiece({PieceTypes::PAWN, capturedColour});
-        
-        //Hashing in the captured pawn
-        hashPieceChange(convertOuterBoardIndex(enPassantCaptureIndex, cornerIndex), PieceTypes::PAWN, capturedColour);
+    if (mv.isCastle()) {
+        performCastling(mv, movingColour, true);
     }
     
-    enPassantActive = mv.enPassantActive;
-    enPassantTarget = mv.enPassantTarget;
-    
-    if (mv.isCastle || mv.fromPieceType == PieceTypes::ROOK || mv.fromPieceType == PieceTypes::KING) {
-        hashCastleRights();
-        castleRights = mv.castleRights;
-        hashCastleRights();
+    if (mv.isEnPassant()) {
+        placePiece(toSq + (isWhiteTurn ? -INNER_BOARD_SIZE : INNER_BOARD_SIZE), 
+                PieceTypes::PAWN, getOppositeColour(movingColour));
+    } else if (undo.capturedType != PieceTypes::UNKNOWN) {
+        placePiece(toSq, undo.capturedType, getOppositeColour(movingColour));
     }
     
-    if (mv.isCastle) {
-        const auto isQueenSide = (mv.toSq->getOffset() - mv.fromSq->getOffset() < 0);
-        
-        std::swap(vectorTable[distToEndSquare - 1 + (isQueenSide << 1)], 
-            vectorTable[distToEndSquare + 1 - (isQueenSide * 3)]);
-            
-        const auto temp = vectorTable[distToEndSquare - 1 + (isQueenSide << 1)]->getOffset();
-        
-        vectorTable[distToEndSquare - 1 + (isQueenSide << 1)]->setOffset(
-            vectorTable[distToEndSquare + 1 - (isQueenSide * 3)]->getOffset());
-            
-        vectorTable[distToEndSquare + 1 - (isQueenSide * 3)]->setOffset(temp);
-
-        hashPieceChange(convertOuterBoardIndex(distToFromSquare + 3 - (isQueenSide * 7), cornerIndex), PieceTypes::ROOK, mv.fromPieceColour);
-        hashPieceChange(convertOuterBoardIndex(distToFromSquare + 1 - (isQueenSide << 1), cornerIndex), PieceTypes::ROOK, mv.fromPieceColour);
-    }
-
-    std::rotate(repititionList.rbegin(), repititionList.rbegin() + 1, repititionList.rend());
-    repititionList[0] = currHash;
+    enPassantActive = undo.enPassantActive;
+    enPassantTarget = undo.enPassantTarget;
+    castleRights = undo.castleRights;
+    halfMoveClock = undo.halfMoveClock;
+    moveCounter = undo.moveCounter;
+    checkers = undo.checkers;
     
-    updateCheckStatus();
-
-    halfMoveClock = mv.halfMoveClock;
-    moveCounter = mv.moveCounter;
+    //Restoring the saved hash replaces hashing out the turn, castling and en passant changes
+    currHash = undo.hash;
     
     assert(checkBoardValidity());
 }
@@ -593,38 +247,29 @@ void Board::unmakeMove(const Move& mv) {
 /**
  * Generates a FEN string represnting the current board state.
  */
-std::string Board::generateFEN() {
+std::string Board::generateFEN() const {
     std::string output;
-    int emptySquareCounter = 0;
-    int rowCount = 1;
-    bool rowContainsGameBoard = false;
-    for (size_t i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        const auto& sq = vectorTable[i].get();
-        if (!sq->getPiece()) {
-            emptySquareCounter++;
-            rowContainsGameBoard = true;
-        } else if (!sq->checkSentinel()) {
-            rowContainsGameBoard = true;
-            const auto& squarePiece = sq->getPiece();
-            const auto& charCaseFunction = (squarePiece->getColour() == Colour::WHITE) ? toupper : tolower;
+    for (int rank = INNER_BOARD_SIZE - 1; rank >= 0; --rank) {
+        int emptySquareCounter = 0;
+        for (int file = 0; file < INNER_BOARD_SIZE; ++file) {
+            const auto square = makeSquare(rank, file);
+            const auto colour = getPieceColour(square);
+            if (colour == Colour::UNKNOWN) {
+                ++emptySquareCounter;
+                continue;
+            }
             if (emptySquareCounter) {
                 output += std::to_string(emptySquareCounter);
-            }
-            output += charCaseFunction(static_cast<char>(squarePiece->getType()));
-            emptySquareCounter = 0;
-        }
-        if (i % OUTER_BOARD_SIZE == 14) {
-            if (rowContainsGameBoard) {
-                if (emptySquareCounter) {
-                    output += std::to_string(emptySquareCounter);
-                }
-                if (rowCount < INNER_BOARD_SIZE) {
-                    output += '/';
-                }
                 emptySquareCounter = 0;
-                rowCount++;
             }
-            rowContainsGameBoard = false;
+            const auto pieceChar = static_cast<char>(getPieceType(square));
+            output += (colour == Colour::WHITE) ? pieceChar : static_cast<char>(std::tolower(pieceChar));
+        }
+        if (emptySquareCounter) {
+            output += std::to_string(emptySquareCounter);
+        }
+        if (rank) {
+            output += '/';
         }
     }
     output += ' ';
@@ -647,12 +292,7 @@ std::string Board::generateFEN() {
     }
     output += ' ';
     if (enPassantActive) {
-        const auto distToCurrSquare = getSquareIndex(enPassantTarget);
-        assert(distToCurrSquare != -1);
-        const auto cornerDist = findCorner_1D();
-        const auto distToTarget = distToCurrSquare - cornerDist;
-        output += static_cast<char>(97 + (distToTarget % OUTER_BOARD_SIZE));
-        output += std::to_string(INNER_BOARD_SIZE - (distToTarget / OUTER_BOARD_SIZE));
+        output += convertSquareToCoordText(enPassantTarget);
     } else {
         output += '-';
     }
@@ -667,46 +307,30 @@ std::string Board::generateFEN() {
  * Counts the material on the board to check if it would cause a draw due to
  * insufficient material.
  */
-bool Board::drawByMaterial() {
-    const int cornerIndex = findCorner_1D();
-    int minorCount = 0;
-    bool whiteBishopFound = false;
-    bool blackBishopFound = false;
-    std::pair<int, int> whiteBishopCoords = {0,0};
-    std::pair<int, int> blackBishopCoords = {0,0};
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            const auto& currPiece = vectorTable[cornerIndex + (i * OUTER_BOARD_SIZE) + j]->getPiece();
-            if (currPiece) {
-                const PieceTypes type = currPiece->getType();
-                if (type == PieceTypes::PAWN || type == PieceTypes::ROOK || type == PieceTypes::QUEEN) {
-                    return false;
-                }
-                if (type == PieceTypes::KNIGHT || type == PieceTypes::BISHOP) {
-                    minorCount++;
-                    if (type == PieceTypes::BISHOP) {
-                        if (currPiece->getColour() == Colour::WHITE) {
-                            whiteBishopFound = true;
-                            whiteBishopCoords = {i, j};
-                        } else {
-                            blackBishopFound = true;
-                            blackBishopCoords = {i, j};
-                        }
-                    }
-                }
-            }
+bool Board::drawByMaterial() const {
+    for (const auto colour : {Colour::WHITE, Colour::BLACK}) {
+        if (getPieceBoard(PieceTypes::PAWN, colour) || getPieceBoard(PieceTypes::ROOK, colour) 
+                || getPieceBoard(PieceTypes::QUEEN, colour)) {
+            return false;
         }
     }
+    const auto whiteBishops = getPieceBoard(PieceTypes::BISHOP, Colour::WHITE);
+    const auto blackBishops = getPieceBoard(PieceTypes::BISHOP, Colour::BLACK);
+    const int minorCount = getPieceCount(PieceTypes::BISHOP, Colour::WHITE) + getPieceCount(PieceTypes::BISHOP, Colour::BLACK) 
+        + getPieceCount(PieceTypes::KNIGHT, Colour::WHITE) + getPieceCount(PieceTypes::KNIGHT, Colour::BLACK);
+    
     if (minorCount < 2) {
         return true;
     }
     if (minorCount > 2) {
         return false;
     }
-    if (whiteBishopFound && blackBishopFound) {
-        //perform bishop colour check, returns 0 if white, 1 if black and checks if they are equal
-        if (((whiteBishopCoords.first & 1) ^ (whiteBishopCoords.second & 1)) 
-                == ((blackBishopCoords.first & 1) ^ (blackBishopCoords.second & 1))) {
+    if (whiteBishops && blackBishops) {
+        //perform bishop colour check, returns 0 if dark, 1 if light and checks if they are equal
+        const auto whiteBishopSquare = getLowestSquare(whiteBishops);
+        const auto blackBishopSquare = getLowestSquare(blackBishops);
+        if (((getRank(whiteBishopSquare) ^ getFile(whiteBishopSquare)) & 1) 
+                == ((getRank(blackBishopSquare) ^ getFile(blackBishopSquare)) & 1)) {
             return true;
         }
     }
@@ -735,30 +359,41 @@ std::string Board::promptPromotionType() const {
 }
 
 /**
- * Updates the current check status of the board after a move is made or unmade.
+ * Updates the set of pieces giving check to the player to move.
+ * Unmaking a move restores the previous set from the state history instead of calling this.
  */
 void Board::updateCheckStatus() {
-    const auto corner = findCorner_1D();
-    int whiteIndex = -1;
-    int blackIndex = -1;
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            const auto piece = vectorTable[corner + (i * OUTER_BOARD_SIZE) + j]->getPiece();
-            if (piece && piece->getType() == PieceTypes::KING) {
-                if (piece->getColour() == Colour::WHITE) {
-                    assert(whiteIndex == -1); //Ensure no multiple kings exist
-                    whiteIndex = corner + (i * OUTER_BOARD_SIZE) + j;
-                } else {
-                    assert(blackIndex == -1); //Ensure no multiple kings exist
-                    blackIndex = corner + (i * OUTER_BOARD_SIZE) + j;
-                }
-            }
-        }
-    }
-    assert(whiteIndex != -1);
-    assert(blackIndex != -1);
-    whiteInCheck = moveGen.inCheck(whiteIndex);
-    blackInCheck = moveGen.inCheck(blackIndex);
+    //Ensure exactly one king of each colour exists
+    assert(popCount(getPieceBoard(PieceTypes::KING, Colour::WHITE)) == 1);
+    assert(popCount(getPieceBoard(PieceTypes::KING, Colour::BLACK)) == 1);
+    const auto colour = (isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
+    checkers = attackersTo(getKingSquare(colour), getOccupancy()) & getColourBoard(getOppositeColour(colour));
+}
+
+/**
+ * Returns every piece of either colour attacking a square, given an occupancy for sliding pieces to stop at.
+ * Pawn attackers are found by looking backwards with the pawn attacks of the opposite colour.
+ */
+Bitboard Board::attackersTo(const int square, const Bitboard occupancy) const {
+    const auto bishopsQueens = pieceBoards[getPieceCode(PieceTypes::BISHOP, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::BISHOP, Colour::BLACK)]
+        | pieceBoards[getPieceCode(PieceTypes::QUEEN, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::QUEEN, Colour::BLACK)];
+    const auto rooksQueens = pieceBoards[getPieceCode(PieceTypes::ROOK, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::ROOK, Colour::BLACK)]
+        | pieceBoards[getPieceCode(PieceTypes::QUEEN, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::QUEEN, Colour::BLACK)];
+    const auto knights = pieceBoards[getPieceCode(PieceTypes::KNIGHT, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::KNIGHT, Colour::BLACK)];
+    const auto kings = pieceBoards[getPieceCode(PieceTypes::KING, Colour::WHITE)] 
+        | pieceBoards[getPieceCode(PieceTypes::KING, Colour::BLACK)];
+        
+    return (getPawnAttacks(square, Colour::WHITE) & getPieceBoard(PieceTypes::PAWN, Colour::BLACK))
+        | (getPawnAttacks(square, Colour::BLACK) & getPieceBoard(PieceTypes::PAWN, Colour::WHITE))
+        | (getKnightAttacks(square) & knights)
+        | (getKingAttacks(square) & kings)
+        | (getBishopAttacks(square, occupancy) & bishopsQueens)
+        | (getRookAttacks(square, occupancy) & rooksQueens);
 }
 
 /**
@@ -768,31 +403,32 @@ void Board::updateCheckStatus() {
  * As such, it is not publicly exposed to the end user in the interface.
  */
 void Board::setPositionByFEN(const std::string& fen) {
-    const auto cornerDist = findCorner_1D();
     std::stringstream fenStream(fen);
     std::array<std::string, 6> fenSections;
     for (int i = 0; fenStream.good() && i < 6; ++i) {
         fenStream >> fenSections[i];
     }
     
+    pieceBoards.fill(0);
+    colourBoards.fill(0);
+    mailbox.fill(EMPTY_SQUARE);
+    pawnHash = 0;
+    materialHash = 0;
+    
     //Append a special character to detect the end of the string
     fenSections[0].push_back('#');
     
     for (int i = 0, currStrPos = 0, currSquareIdx = 0; i < INNER_BOARD_SIZE; ++i) {
         while (fenSections[0][currStrPos] != '/' && fenSections[0][currStrPos] != '#') {
             if (std::isdigit(fenSections[0][currStrPos])) {
-                const auto jumpLength = fenSections[0][currStrPos] - '0';
-                for (int j = 0; j < jumpLength; ++j) {
-                    vectorTable[cornerDist + (OUTER_BOARD_SIZE * i) + currSquareIdx + j]->setPiece(nullptr);
-                }
-                currSquareIdx += jumpLength;
+                currSquareIdx += fenSections[0][currStrPos] - '0';
                 ++currStrPos;
                 continue;
             }
             
-            vectorTable[cornerDist + (OUTER_BOARD_SIZE * i) + currSquareIdx]->setPiece(
-                {static_cast<PieceTypes>(std::toupper(fenSections[0][currStrPos])), 
-                    (std::isupper(fenSections[0][currStrPos])) ? Colour::WHITE : Colour::BLACK});
+            placePiece(makeSquare(INNER_BOARD_SIZE - 1 - i, currSquareIdx), 
+                static_cast<PieceTypes>(std::toupper(fenSections[0][currStrPos])), 
+                (std::isupper(fenSections[0][currStrPos])) ? Colour::WHITE : Colour::BLACK);
                     
             ++currStrPos;
             ++currSquareIdx;
@@ -821,22 +457,16 @@ void Board::setPositionByFEN(const std::string& fen) {
         }
     }
     
-    if (fenSections[3].find_first_of('-') != std::string::npos) {
-        enPassantActive = false;
-        enPassantTarget = nullptr;
-    } else {
-        // Convert the letter to a digit
-        fenSections[3][0] -= 49;
-        // Change input to zero-indexed value
-        fenSections[3][1] -= 1;
-        // Change chars to digits
-        fenSections[3][0] -= '0';
-        fenSections[3][1] -= '0';
-        
-        enPassantActive = true;
-        enPassantTarget = vectorTable[((INNER_BOARD_SIZE - 1 
-            - fenSections[3][1]) * OUTER_BOARD_SIZE) + cornerDist 
-            + fenSections[3][0]].get();
+    enPassantActive = false;
+    enPassantTarget = -1;
+    if (fenSections[3].find_first_of('-') == std::string::npos) {
+        //As in addEnPassantTarget, the target is only kept if a pawn of the player to move can capture it
+        const auto target = makeSquare(fenSections[3][1] - '1', fenSections[3][0] - 'a');
+        const auto movingColour = (isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
+        if (getPawnAttacks(target, getOppositeColour(movingColour)) & getPieceBoard(PieceTypes::PAWN, movingColour)) {
+            enPassantActive = true;
+            enPassantTarget = target;
+        }
     }
     
     if (!fenSections[4].empty() && std::all_of(fenSections[4].begin(), fenSections[4].end(), ::isdigit)) {
@@ -851,8 +481,6 @@ void Board::setPositionByFEN(const std::string& fen) {
     currHash = std::hash<Board>()(*this);
     
     //Resetting the check status
-    blackInCheck = false;
-    whiteInCheck = false;
     updateCheckStatus();
 }
 
@@ -860,55 +488,69 @@ void Board::setPositionByFEN(const std::string& fen) {
  * This method is a testing method used for validating the current board
  * state is as it should be.
  * This includes checks for en passant having a valid target when it is active,
- * ensuring the 8x8 board is consistent and contains no sentinel values.
+ * and ensuring the piece bitboards agree with each other, the colour bitboards and the mailbox.
  * The most important check this method performs is a forced reset validation of the board hash,
  * ensuring the incremental update is fully equivalent to a complete rehash.
  */
 bool Board::checkBoardValidity() {
-    int cornerCoords;
-    if ((cornerCoords = findCorner_1D()) == -1) {
-        std::cerr << "Could not find corner\n";
+    if (colourBoards[0] & colourBoards[1]) {
+        std::cerr << "Colour bitboards overlap\n";
         return false;
     }
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            if (!vectorTable[cornerCoords + (i * OUTER_BOARD_SIZE) + j]) {
-                std::cerr << "Board square is null\n";
-                printBoardState();
-                return false;
-            }
-            if (vectorTable[cornerCoords + (i * OUTER_BOARD_SIZE) + j]->checkSentinel()) {
-                std::cerr << "Square is sentinel when it shouldn't be\n";
-                printBoardState();
-                return false;
-            }
+    Bitboard allPieces = 0;
+    for (int i = 0; i < NUM_SQUARE_STATES; ++i) {
+        if (allPieces & pieceBoards[i]) {
+            std::cerr << "Piece bitboards overlap\n";
+            printBoardState();
+            return false;
+        }
+        if ((pieceBoards[i] & colourBoards[i / 6]) != pieceBoards[i]) {
+            std::cerr << "Piece bitboard does not match its colour bitboard\n";
+            printBoardState();
+            return false;
         }
+        allPieces |= pieceBoards[i];
     }
-    if (enPassantActive && !enPassantTarget) {
+    if (allPieces != getOccupancy()) {
+        std::cerr << "Occupancy does not match the piece bitboards\n";
+        return false;
+    }
+    for (int i = 0; i < INNER_BOARD_SIZE * INNER_BOARD_SIZE; ++i) {
+        const auto code = mailbox[i];
+        if ((code == EMPTY_SQUARE) ? (allPieces & squareMask(i)) != 0 : !(pieceBoards[code] & squareMask(i))) {
+            std::cerr << "Mailbox does not match the piece bitboards\n";
+            printBoardState();
+            return false;
+        }
+    }
+    if (enPassantActive && enPassantTarget == -1) {
         std::cerr << "En passant target should never be null when en passant is active\n";
         return false;
     }
     
-    if (std::find_if(vectorTable.cbegin(), vectorTable.cend(), 
-            [](const auto& sq){
-                const auto& piece = sq->getPiece();
-                return piece && piece->getType() == PieceTypes::KING 
-                    && piece->getColour() == Colour::WHITE;
-            }) == vectorTable.cend()) {
+    if (popCount(getPieceBoard(PieceTypes::KING, Colour::WHITE)) != 1) {
         std::cerr << "Could not find white king\n";
         return false;
     }
     
-    if (std::find_if(vectorTable.cbegin(), vectorTable.cend(), 
-            [](const auto& sq){
-                const auto& piece = sq->getPiece();
-                return piece && piece->getType() == PieceTypes::KING 
-                    && piece->getColour() == Colour::BLACK;
-            }) == vectorTable.cend()) {
+    if (popCount(getPieceBoard(PieceTypes::KING, Colour::BLACK)) != 1) {
         std::cerr << "Could not find black king\n";
         return false;
     }
     
+    if (!(getPieceBoard(PieceTypes::KING, Colour::WHITE) & squareMask(kingSquares[0])) 
+            || !(getPieceBoard(PieceTypes::KING, Colour::BLACK) & squareMask(kingSquares[1]))) {
+        std::cerr << "King squares do not match the king bitboards\n";
+        return false;
+    }
+    
+    const auto colour = (isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
+    if (checkers != (attackersTo(kingSquares[getColourIndex(colour)], getOccupancy()) 
+                & getColourBoard(getOppositeColour(colour)))) {
+        std::cerr << "Checkers do not match the pieces attacking the king\n";
+        return false;
+    }
+    
     const auto tempHash = currHash;
     currHash = 0;
     currHash = std::hash<Board>()(*this);
@@ -918,85 +560,27 @@ bool Board::checkBoardValidity() {
         std::cout << currHash << "\t" << tempHash << "\n";
         return false;
     }
+    
+    if (pawnHash != computePawnHash() || materialHash != computeMaterialHash()) {
+        std::cerr << "Pawn or material hash does not match a full rehash\n";
+        return false;
+    }
     return true;
 }
 
 /**
- * Converts a given square pointer to text.
- * If a square pointer points to g3, returns the text "g3".
+ * Converts a given square index to text.
+ * If the index refers to g3, returns the text "g3".
  */
-std::string Board::convertSquareToCoordText(const Square *sq) {
-    const auto cornerCoords = findCorner_1D();
-    const auto squareDist = getSquareIndex(sq);
-    assert(squareDist != -1);
-    const auto innerDist = convertOuterBoardIndex(squareDist, cornerCoords);
-    
-    return static_cast<char>('a' + (innerDist % INNER_BOARD_SIZE)) 
-        + std::to_string(INNER_BOARD_SIZE - (innerDist / INNER_BOARD_SIZE));
+std::string Board::convertSquareToCoordText(const int square) const {
+    return static_cast<char>('a' + getFile(square)) + std::to_string(getRank(square) + 1);
 }
 
 /**
  * Complement to the above method, converts the from and to squares to text.
  */
-std::string Board::convertMoveToCoordText(const Move& mv) {
-    return convertSquareToCoordText(mv.fromSq) + convertSquareToCoordText(mv.toSq);
-}
-
-/**
- * Performs a linear search on the board to find a given square
- * based on a pointer to it.
- * It only searches for valid on-board squares as it searches only the 8x8 board, instead of
- * the full 15x15.
- */
-int Board::getSquareIndex(const Square *sq) {
-    if (!sq) {
-        return -1;
-    }
-
-    const auto cornerIndex = findCorner_1D();
-
-    assert(cornerIndex >= 0);
-    assert(cornerIndex < 225);
-
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            assert((cornerIndex + (i * OUTER_BOARD_SIZE) + j) < 225);
-            assert((cornerIndex + (i * OUTER_BOARD_SIZE) + j) >= 0);
-            if (*vectorTable[cornerIndex + (i * OUTER_BOARD_SIZE) + j].get() == *sq) {
-                return cornerIndex + (i * OUTER_BOARD_SIZE) + j;
-            }
-        }
-    }
-    return -1;
-}
-
-/**
- * Checks whether en passant is valid after a given move based on an en passant capture
- * resulting in uncovering a pin, resulting in check, which is an invalid move.
- */
-bool Board::checkEnPassantValidity(Square *sq, const Move& mv) {
-    //Enemy pawn and enemy king - perform check check on left square
-    std::unique_ptr<Piece> temp{sq->releasePiece()};
-
-    const auto cornerIndex = findCorner_1D();
-
-    //Get opposite colour king position
-    int idx = -1;
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            const auto piece = vectorTable[cornerIndex + (i * OUTER_BOARD_SIZE) + j]->getPiece();
-            if (piece && piece->getType() == PieceTypes::KING && piece->getColour() != mv.fromPieceColour) {
-                idx = cornerIndex + (i * OUTER_BOARD_SIZE) + j;
-                break;
-            }
-        }
-    }
-    assert(idx != -1);
-
-    const auto result = moveGen.inCheck(idx);
-    sq->setPiece(std::move(temp));
-
-    return !result;
+std::string Board::convertMoveToCoordText(const Move mv) const {
+    return convertSquareToCoordText(mv.getFromSq()) + convertSquareToCoordText(mv.getToSq());
 }
 
 /**
@@ -1009,148 +593,89 @@ void Board::removeCastlingRights(const unsigned char flag) {
 }
 
 /**
- * This method disables castling based on the piece that moved.
+ * This method disables castling based on the squares a move touches.
+ * Moving a king or rook off of its starting square, or capturing a rook on it, removes
+ * the matching castling rights.
  */
-void Board::disableCastling(const Move& mv) {
-    // Disable castling if the appropriate rook moves
-    if (mv.fromPieceType == PieceTypes::ROOK) {
-        if (mv.fromPieceColour == Colour::WHITE && (castleRights & WHITE_CASTLE_FLAG)) {
-            const int backRankIndex = findCorner_1D() + (7 * OUTER_BOARD_SIZE);
-            if (*(vectorTable[backRankIndex].get()) == *mv.fromSq) {
-                removeCastlingRights(WHITE_CASTLE_QUEEN_FLAG);
-            }
-            if (*(vectorTable[backRankIndex + 7].get()) == *mv.fromSq) {
-                removeCastlingRights(WHITE_CASTLE_KING_FLAG);
-            }
-        } else if (mv.fromPieceColour == Colour::BLACK && (castleRights & BLACK_CASTLE_FLAG)) {
-            const int backRankIndex = findCorner_1D();
-            if (*(vectorTable[backRankIndex].get()) == *mv.fromSq) {
-                removeCastlingRights(BLACK_CASTLE_QUEEN_FLAG);
-            }
-            if (*(vectorTable[backRankIndex + 7].get()) == *mv.fromSq) {
-                removeCastlingRights(BLACK_CASTLE_KING_FLAG);
-            }
-        }
-    } else if (mv.fromPieceType == PieceTypes::KING) {
-        if (mv.fromPieceColour == Colour::WHITE && (castleRights & WHITE_CASTLE_FLAG)) {
-            removeCastlingRights(WHITE_CASTLE_FLAG);
-        } else if (mv.fromPieceColour == Colour::BLACK && (castleRights & BLACK_CASTLE_FLAG)) {
-            removeCastlingRights(BLACK_CASTLE_FLAG);
+void Board::disableCastling(const Move mv) {
+    if (!castleRights) {
+        return;
+    }
+    static const std::array<std::pair<int, unsigned char>, 6> castleSquares{{
+        {0, WHITE_CASTLE_QUEEN_FLAG}, 
+        {4, WHITE_CASTLE_FLAG}, 
+        {7, WHITE_CASTLE_KING_FLAG}, 
+        {56, BLACK_CASTLE_QUEEN_FLAG}, 
+        {60, BLACK_CASTLE_FLAG}, 
+        {63, BLACK_CASTLE_KING_FLAG}
+    }};
+    
+    for (const auto& castleSquare : castleSquares) {
+        if ((castleRights & castleSquare.second) 
+                && (mv.getFromSq() == castleSquare.first || mv.getToSq() == castleSquare.first)) {
+            removeCastlingRights(castleSquare.second);
         }
     }
 }
 
 /**
- * Adds an en passant target to the board is it is valid.
- * Part of that validity check involves calling checkEnPassantValidity on the neighbouring squares.
+ * Adds an en passant target to the board after a pawn double move.
+ * The target is only added if an enemy pawn is in position to capture it.
  */
-void Board::addEnPassantTarget(const Move& mv, const int offset, const int columnNum, const int endSquareIndex) {
-    // Add en Passant target if pawn double move was made.
-    if (std::abs(offset) == 30 && mv.fromPieceType == PieceTypes::PAWN) {
-        auto left = vectorTable[endSquareIndex - 1].get();
-        auto right = vectorTable[endSquareIndex + 1].get();
-
-        if (left->getPiece() || right->getPiece()) {
-            if (left->getPiece() && right->getPiece()) {
-                const auto isLeftPawn = (left->getPiece()->getType() == PieceTypes::PAWN 
-                        && left->getPiece()->getColour() != mv.fromPieceColour);
-                const auto isRightPawn = (right->getPiece()->getType() == PieceTypes::PAWN 
-                        && right->getPiece()->getColour() != mv.fromPieceColour);
-                if (isLeftPawn ^ isRightPawn) {
-                    if (isLeftPawn) {
-                        //Check right square for its piece type
-                        if (right->getPiece()->getVectorLength() == INNER_BOARD_SIZE 
-                                || (right->getPiece()->getType() == PieceTypes::KING 
-                                    && right->getPiece()->getColour() != mv.fromPieceColour)) {
-                            //Enemy pawn and enemy king - perform check check on left square
-                            if (!checkEnPassantValidity(left, mv)) {
-                                return;
-                            }
-                        }
-                    } else {
-                        //Check left square for its piece type
-                        if (left->getPiece()->getVectorLength() == INNER_BOARD_SIZE 
-                                || (left->getPiece()->getType() == PieceTypes::KING 
-                                    && left->getPiece()->getColour() != mv.fromPieceColour)) {
-                            //Enemy pawn and enemy king - perform check check on right square
-                            if (!checkEnPassantValidity(right, mv)) {
-                                return;
-                            }
-                        }
-                    }
-                }
-            } else if (left->getPiece() && left->getPiece()->getType() == PieceTypes::PAWN 
-                    && left->getPiece()->getColour() != mv.fromPieceColour) {
-                //Perform check check on left square
-                if (!checkEnPassantValidity(left, mv)) {
-                    return;
-                }
-            } else if (right->getPiece() && right->getPiece()->getType() == PieceTypes::PAWN 
-                    && right->getPiece()->getColour() != mv.fromPieceColour) {
-                //Perform check check on right square
-                if (!checkEnPassantValidity(right, mv)) {
-                    return;
-                }
-            }
-        }
+void Board::addEnPassantTarget(const Move mv, const Colour colour) {
+    if (std::abs(mv.getToSq() - mv.getFromSq()) != (INNER_BOARD_SIZE << 1)) {
+        return;
+    }
+    const auto target = (mv.getFromSq() + mv.getToSq()) >> 1;
+    const auto enemyPawns = getPieceBoard(PieceTypes::PAWN, getOppositeColour(colour));
 
+    if (getPawnAttacks(target, colour) & enemyPawns) {
         enPassantActive = true;
-        enPassantTarget = vectorTable[endSquareIndex + (offset / 2)].get();
+        enPassantTarget = target;
         
         //xor in en passant file
-        hashEnPassantFile((endSquareIndex % OUTER_BOARD_SIZE) - (INNER_BOARD_SIZE - 1 - columnNum));
+        hashEnPassantFile(getFile(target));
     }
 }
 
 /**
- * Performs castling on the board for a given move.
+ * Moves the rook involved in castling, or moves it back if the castle is being undone.
  */
-void Board::performCastling(Move& mv, const int offset, const int fromSquareIndex) {
-    const bool castleDirectionChosen = moveGen.getCastleDirectionBool(mv.fromPieceType, mv.fromPieceColour, offset);
-    //Perform castling
-    if (mv.fromPieceType == PieceTypes::KING && std::abs(offset) == 2 && castleDirectionChosen) {
-        const auto cornerIndex = findCorner_1D();
-        mv.isCastle = true;
-        
-        const auto isQueenSide = (offset < 0);
-        
-        std::swap(vectorTable[fromSquareIndex + 3 - (isQueenSide * 7)], 
-            vectorTable[fromSquareIndex + 1 - (isQueenSide << 1)]);
-        const auto temp = vectorTable[fromSquareIndex + 3 - (isQueenSide * 7)]->getOffset();
-        vectorTable[fromSquareIndex + 3 - (isQueenSide * 7)]->setOffset(
-            vectorTable[fromSquareIndex + 1 - (isQueenSide << 1)]->getOffset());
-        vectorTable[fromSquareIndex + 1 - (isQueenSide << 1)]->setOffset(temp);
-        
-        hashPieceChange(convertOuterBoardIndex(fromSquareIndex + 3 - (isQueenSide * 7), cornerIndex), 
-                PieceTypes::ROOK, mv.fromPieceColour);
-        hashPieceChange(convertOuterBoardIndex(fromSquareIndex + 1 - (isQueenSide << 1), cornerIndex), 
-                PieceTypes::ROOK, mv.fromPieceColour);
-            
-        if (mv.fromPieceColour == Colour::WHITE) {
-            removeCastlingRights(WHITE_CASTLE_FLAG);
-        } else {
-            removeCastlingRights(BLACK_CASTLE_FLAG);
-        }
-    }
+void Board::performCastling(const Move mv, const Colour colour, const bool isUndo) {
+    const auto isQueenSide = (mv.getToSq() < mv.getFromSq());
+    const auto rookStart = (isQueenSide) ? mv.getFromSq() - 4 : mv.getFromSq() + 3;
+    const auto rookEnd = (isQueenSide) ? mv.getFromSq() - 1 : mv.getFromSq() + 1;
+    
+    removePiece((isUndo) ? rookEnd : rookStart, PieceTypes::ROOK, colour);
+    placePiece((isUndo) ? rookStart : rookEnd, PieceTypes::ROOK, colour);
 }
 
 /**
- * Performs an en passant catpure and removes the captured piece.
+ * Adds a piece to the bitboards and mailbox, and hashes it in.
  */
-void Board::captureEnPassant(const Move& mv, const int offset, const int toSquareIndex) {
-    const auto captureIndex = toSquareIndex - OUTER_BOARD_SIZE + ((isWhiteTurn) * OUTER_BOARD_SIZE << 1);
-    const auto cornerIndex = findCorner_1D();
-    // If en passant move is made, capture the appropriate pawn
-    if (enPassantActive && mv.fromPieceType == PieceTypes::PAWN 
-            && (offset % OUTER_BOARD_SIZE) && *mv.toSq == *enPassantTarget
-            && vectorTable[captureIndex]->getPiece() 
-            && vectorTable[captureIndex]->getPiece()->getColour() != mv.fromPieceColour) {
-        vectorTable[captureIndex]->setPiece(nullptr);
-        
-        //xor out the captured pawn
-        hashPieceChange(convertOuterBoardIndex(captureIndex, cornerIndex), PieceTypes::PAWN, 
-                (mv.fromPieceColour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE);
+inline void Board::placePiece(const int square, const PieceTypes type, const Colour colour) {
+    assert(!(getOccupancy() & squareMask(square)));
+    const auto code = getPieceCode(type, colour);
+    pieceBoards[code] |= squareMask(square);
+    colourBoards[getColourIndex(colour)] |= squareMask(square);
+    mailbox[square] = code;
+    if (type == PieceTypes::KING) {
+        kingSquares[getColourIndex(colour)] = square;
     }
+    hashPieceChange(square, type, colour);
+    hashMaterialChange(type, colour, popCount(pieceBoards[code]));
+}
+
+/**
+ * Removes a piece from the bitboards and mailbox, and hashes it out.
+ */
+inline void Board::removePiece(const int square, const PieceTypes type, const Colour colour) {
+    assert(getPieceBoard(type, colour) & squareMask(square));
+    hashMaterialChange(type, colour, getPieceCount(type, colour));
+    pieceBoards[getPieceCode(type, colour)] &= ~squareMask(square);
+    colourBoards[getColourIndex(colour)] &= ~squareMask(square);
+    mailbox[square] = EMPTY_SQUARE;
+    hashPieceChange(square, type, colour);
 }
 
 /**
@@ -1159,67 +684,84 @@ void Board::captureEnPassant(const Move& mv, const int offset, const int toSquar
  * The hashing call is done to this function.
  */
 inline void Board::hashPieceChange(const int index, const PieceTypes type, const Colour colour) {
-    assert(pieceLookupTable.find(type) != pieceLookupTable.end());
+    assert(getPieceIndex(type) >= 0);
     assert(index >= 0);
-    assert(pieceLookupTable.find(type)->second >= 0);
-    currHash ^= HASH_VALUES[NUM_SQUARE_STATES * index + pieceLookupTable.find(type)->second + (6 * (colour == Colour::BLACK))];
+    const auto key = HASH_VALUES[getPieceHashIndex(index, getPieceIndex(type), colour == Colour::WHITE)];
+    currHash ^= key;
+    if (type == PieceTypes::PAWN) {
+        pawnHash ^= key;
+    }
+}
+
+/**
+ * Incrementally updates the material hash when the number of pieces of one type changes.
+ * Each piece is keyed by how many of its type there are, so the count replaces the square in the key lookup.
+ * This is called with the count including the piece being added or removed.
+ */
+inline void Board::hashMaterialChange(const PieceTypes type, const Colour colour, const int count) {
+    assert(count > 0);
+    materialHash ^= HASH_VALUES[getPieceHashIndex(count - 1, getPieceIndex(type), colour == Colour::WHITE)];
+}
+
+/**
+ * Computes the pawn hash from scratch, for validating the incremental updates.
+ */
+size_t Board::computePawnHash() const {
+    size_t result = 0;
+    for (const auto colour : {Colour::WHITE, Colour::BLACK}) {
+        auto pawns = getPieceBoard(PieceTypes::PAWN, colour);
+        while (pawns) {
+            result ^= HASH_VALUES[getPieceHashIndex(popLowestSquare(pawns), getPieceIndex(PieceTypes::PAWN), colour == Colour::WHITE)];
+        }
+    }
+    return result;
+}
+
+/**
+ * Computes the material hash from scratch, for validating the incremental updates.
+ */
+size_t Board::computeMaterialHash() const {
+    size_t result = 0;
+    for (const auto colour : {Colour::WHITE, Colour::BLACK}) {
+        for (const auto type : PIECE_TYPE_LIST) {
+            for (int i = 0; i < getPieceCount(type, colour); ++i) {
+                result ^= HASH_VALUES[getPieceHashIndex(i, getPieceIndex(type), colour == Colour::WHITE)];
+            }
+        }
+    }
+    return result;
 }
 
 /**
  * Incrementally updates the hash based on the change in turn.
  */
 inline void Board::hashTurnChange() {
-    currHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::WHITE_MOVE)];
+    currHash ^= HASH_VALUES[HASH_WHITE_MOVE];
 }
 
 /**
  * Incrementally updates the hash based on the change in the en passant file
  */
 inline void Board::hashEnPassantFile(const int fileNum) {
-    currHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::EN_PASSANT_FILE) + fileNum];
+    currHash ^= HASH_VALUES[HASH_EN_PASSANT_FILE + fileNum];
 }
 
 /**
  * Incrementally updates the hash based on the change in castling rights.
  */
 inline void Board::hashCastleRights() {
-    currHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::CASTLE_RIGHTS) + castleRights];
-}
-
-/**
- * Promotes a pawn to a given type when it is appropriate to do so.
- */
-void Board::promotePawn(Move& mv, const int endSquareIndex, const bool isSilent) {
-    const auto cornerIndex = findCorner_1D();
-    //Promote pawns on the end ranks
-    if (mv.fromPieceType == PieceTypes::PAWN) {
-        halfMoveClock = 0;
-        const auto distFromStartToCorner = endSquareIndex - cornerIndex;
-        const auto rowPairs = (mv.fromPieceColour == Colour::WHITE) ? std::make_pair(0, 14) : std::make_pair(105, 119);
-        
-        if (distFromStartToCorner >= rowPairs.first && distFromStartToCorner <= rowPairs.second) {
-            if (isSilent) {
-                mv.fromSq->getPiece()->promote(mv.promotionType);
-                mv.fromPieceType = static_cast<PieceTypes>(mv.promotionType);
-            } else {
-                const auto& input = promptPromotionType();
-                mv.fromSq->getPiece()->promote(static_cast<PieceTypes>(input.front()));
-                mv.fromPieceType = static_cast<PieceTypes>(input.front());
-            }
-            mv.promotionMade = true;
-        }
-    }
+    currHash ^= CASTLE_HASH_VALUES[castleRights];
 }
 
 /**
  * Detects if the board is at an end state, the type of that state, and ends the
  * current game in progress if one has been reached.
+ * The game's position history is needed to detect a threefold repetition.
  */
-void Board::detectGameEnd() {
+void Board::detectGameEnd(const PositionHistory& history) {
     //Opponent has no legal moves
-    if (!moveGen.generateAll().size()) {
-        const auto opponentCheck = (isWhiteTurn) ? whiteInCheck : blackInCheck;
-        if (opponentCheck) {
+    if (!getMoveGen().hasLegalMove()) {
+        if (checkers) {
             //Checkmate
             std::cout << "CHECKMATE\n";
             currentGameState = GameState::MATE;
@@ -1238,7 +780,7 @@ void Board::detectGameEnd() {
         return;
     }
     
-    if (repititionList[0] == repititionList[4] && repititionList[4] == repititionList[8]) {
+    if (history.countRepetitions(*this, 2) >= 2) {
         //Three move Repitition
         std::cout << "DRAW\n";
         std::cout << "Three move repitition\n";
@@ -1254,4 +796,3 @@ void Board::detectGameEnd() {
         return;
     }
 }
-
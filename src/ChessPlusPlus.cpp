@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <omp.h>
 #include "headers/board.h"
+#include "headers/history.h"
 #include "headers/chessplusplus.h"
 #include "headers/ai.h"
 
@@ -44,7 +45,8 @@ int main(int argc, char **argv) {
         }
         if (!input.compare("benchmark")) {
             Board b;
-            AI comp(&b);
+            PositionHistory history;
+            AI comp(&b, &history);
             comp.benchmarkPerft();
             continue;
         }
@@ -211,6 +213,7 @@ bool configureAI(bool& usingTimeLimit, int& timeLimit, int& plyCount) {
 
 void playHumanGame() {
     Board b;
+    PositionHistory history;
     b.printBoardState();
     std::string input;
     while (b.getGameState() == GameState::ACTIVE) {
@@ -254,7 +257,7 @@ void playHumanGame() {
             std::cout << "Not a valid move format\n";
             continue;
         }
-        if (b.makeMove(input)) {
+        if (b.makeMove(input, history)) {
             b.printBoardState();
         }
     }
@@ -262,7 +265,8 @@ void playHumanGame() {
 
 void playMixedGame(bool isAIWhite, bool usingTimeLimit, int timeLimit, int plyCount) {
     Board b;
-    AI comp(&b);
+    PositionHistory history;
+    AI comp(&b, &history);
     if (usingTimeLimit) {
         comp.setMoveTimeLimit(timeLimit);
         comp.setDepth(plyCount);
@@ -297,7 +301,7 @@ void playMixedGame(bool isAIWhite, bool usingTimeLimit, int timeLimit, int plyCo
                     std::cout << "FEN string: " << b.generateFEN() << "\n";
                     continue;
                 }
-                if (checkMoveInputValid(input) && b.makeMove(input)) {
+                if (checkMoveInputValid(input) && b.makeMove(input, history)) {
                     b.printBoardState();
                     break;
                 }
@@ -325,7 +329,7 @@ void playMixedGame(bool isAIWhite, bool usingTimeLimit, int timeLimit, int plyCo
                     std::cout << "FEN string: " << b.generateFEN() << "\n";
                     continue;
                 }
-                if (checkMoveInputValid(input) && b.makeMove(input)) {
+                if (checkMoveInputValid(input) && b.makeMove(input, history)) {
                     b.printBoardState();
                     break;
                 }
@@ -339,8 +343,9 @@ void playMixedGame(bool isAIWhite, bool usingTimeLimit, int timeLimit, int plyCo
 
 void playAIGame(bool usingTimeLimit, int timeLimit, int plyCount) {
     Board b;
-    AI comp1(&b);
-    AI comp2(&b);
+    PositionHistory history;
+    AI comp1(&b, &history);
+    AI comp2(&b, &history);
     if (usingTimeLimit) {
         comp1.setMoveTimeLimit(timeLimit);
         comp1.setDepth(plyCount);
@@ -20,15 +20,12 @@
 #include <memory>
 #include <vector>
 #include <algorithm>
-#include <random>
-#include <chrono>
+#include <utility>
 #include <unordered_map>
-#include "headers/square.h"
 #include "headers/enums.h"
 #include "headers/consts.h"
 
-const std::array<std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE>, INNER_BOARD_SIZE> INIT_BOARD = fillInitBoard();
-const std::array<uint_fast64_t, HASH_BOARD_LENGTH> HASH_VALUES = populateHashTable();
+const std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> INIT_BOARD = fillInitBoard();
 const unsigned char BLACK_CASTLE_FLAG = 0b1100;
 const unsigned char WHITE_CASTLE_FLAG = 0b0011;
 const unsigned char WHITE_CASTLE_QUEEN_FLAG = 0b0010;
@@ -36,65 +33,67 @@ const unsigned char WHITE_CASTLE_KING_FLAG = 0b0001;
 const unsigned char BLACK_CASTLE_QUEEN_FLAG = 0b1000;
 const unsigned char BLACK_CASTLE_KING_FLAG = 0b0100;
 
+/*
+ * Seed for the zobrist keys.
+ * The keys are fixed so that hashes are the same on every run, and can be stored or compared between runs.
+ */
+static constexpr uint64_t HASH_SEED = 0x5A0B1C2D3E4F6071ull;
+
 /**
- * This method populates the global initial board state.
- * I had originally planned early on in development for the board to be reset back to this internal state using
- * a reset method in the board class.
- * This never really became feasible, and as such this init board is merely used to initially construct a board.
+ * Generates the zobrist key at a given index with SplitMix64.
+ * Each key only depends on its index, so the whole table can be built at compile time.
+ */
+static constexpr uint64_t generateHashValue(const uint64_t index) {
+    uint64_t z = HASH_SEED + ((index + 1) * 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Combines the keys of each castling right that is set, as Polyglot hashes the rights individually.
  */
-std::array<std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE>, INNER_BOARD_SIZE> fillInitBoard() {
-    const auto& pickColour = [](const auto T){return (T < 5) ? Colour::BLACK : Colour::WHITE;};
-    std::array<std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE>, INNER_BOARD_SIZE> result;
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE> row;
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            switch(i) {
-                case 0:
-                case 7:
-                    switch(j) {
-                        case 0:
-                        case 7:
-                            row[j] = std::make_unique<Square>(Piece(PieceTypes::ROOK, pickColour(i)));
-                            break;
-                        case 1:
-                        case 6:
-                            row[j] = std::make_unique<Square>(Piece(PieceTypes::KNIGHT, pickColour(i)));
-                            break;
-                        case 2:
-                        case 5:
-                            row[j] = std::make_unique<Square>(Piece(PieceTypes::BISHOP, pickColour(i)));
-                            break;
-                        case 3:
-                            row[j] = std::make_unique<Square>(Piece(PieceTypes::QUEEN, pickColour(i)));
-                            break;
-                        case 4:
-                            row[j] = std::make_unique<Square>(Piece(PieceTypes::KING, pickColour(i)));
-                            break;
-                    }
-                    break;
-                case 1:
-                case 6:
-                    row[j] = std::make_unique<Square>(Piece(PieceTypes::PAWN, pickColour(i)));
-                    break;
-                default:
-                    row[j] = std::make_unique<Square>();
-                    break;
-            }
+static constexpr uint64_t combineCastleHashValues(const unsigned int rights) {
+    uint64_t result = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (rights & (1u << i)) {
+            result ^= generateHashValue(HASH_CASTLE_RIGHTS + i);
         }
-        result[i] = std::move(row);
     }
     return result;
 }
 
+template<size_t... Indices>
+static constexpr std::array<uint64_t, sizeof...(Indices)> populateHashTable(std::index_sequence<Indices...>) {
+    return {{generateHashValue(Indices)...}};
+}
+
+template<size_t... Indices>
+static constexpr std::array<uint64_t, sizeof...(Indices)> populateCastleHashTable(std::index_sequence<Indices...>) {
+    return {{combineCastleHashValues(Indices)...}};
+}
+
+constexpr std::array<uint64_t, HASH_BOARD_LENGTH> HASH_VALUES = populateHashTable(std::make_index_sequence<HASH_BOARD_LENGTH>{});
+constexpr std::array<uint64_t, 16> CASTLE_HASH_VALUES = populateCastleHashTable(std::make_index_sequence<16>{});
+
 /**
- * Populates the hash table values used by zobrist hashing.
+ * This method populates the global initial board state.
+ * I had originally planned early on in development for the board to be reset back to this internal state using
+ * a reset method in the board class.
+ * This never really became feasible, and as such this init board is merely used to initially construct a board.
  */
-std::array<uint_fast64_t, HASH_BOARD_LENGTH> populateHashTable() {
-    std::array<uint_fast64_t, HASH_BOARD_LENGTH> result;
-    std::mt19937_64 gen(std::random_device{}());
-    std::uniform_int_distribution<uint_fast64_t> uni;
-    for (int i = 0; i < HASH_BOARD_LENGTH; ++i) {
-        result[i] = uni(gen);
+std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> fillInitBoard() {
+    static constexpr PieceTypes backRank[] = {
+        PieceTypes::ROOK, PieceTypes::KNIGHT, PieceTypes::BISHOP, PieceTypes::QUEEN, 
+        PieceTypes::KING, PieceTypes::BISHOP, PieceTypes::KNIGHT, PieceTypes::ROOK
+    };
+    std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> result;
+    result.fill(EMPTY_SQUARE);
+    for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
+        result[j] = getPieceCode(backRank[j], Colour::WHITE);
+        result[INNER_BOARD_SIZE + j] = getPieceCode(PieceTypes::PAWN, Colour::WHITE);
+        result[(6 * INNER_BOARD_SIZE) + j] = getPieceCode(PieceTypes::PAWN, Colour::BLACK);
+        result[(7 * INNER_BOARD_SIZE) + j] = getPieceCode(backRank[j], Colour::BLACK);
     }
     return result;
 }
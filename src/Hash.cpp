@@ -22,9 +22,11 @@
 #include <cassert>
 #include "headers/board.h"
 #include "headers/hash.h"
+#include "headers/bitboard.h"
 
 /**
  * Default zobrist hashing implemenation.
+ * The keys follow the Polyglot layout, so with the Polyglot key values this gives Polyglot book keys.
  * Due to the incremental nature of zobrist hashing, each board
  * caches its hash value.
  * Therefore, this method is only ever called in constructors, or
@@ -36,44 +38,25 @@ size_t std::hash<Board>::operator() (Board& b) const {
         return b.currHash;
     }
     
-    const auto& cornerCoords = b.findCorner();
-    const int cornerIndex = (cornerCoords.first * OUTER_BOARD_SIZE) + cornerCoords.second;
     size_t newHash = 0;
     
-    for (int i = cornerCoords.first; i < cornerCoords.first + INNER_BOARD_SIZE; ++i) {
-        for (int j = cornerCoords.second; j < cornerCoords.second + INNER_BOARD_SIZE; ++j) {
-            //Black is (white hash + 6) for equivalent piece types
-            if (b.vectorTable[(i * OUTER_BOARD_SIZE) + j]->getPiece()) {
-                const auto currPiece = b.vectorTable[(i * OUTER_BOARD_SIZE) + j]->getPiece();
-                assert(pieceLookupTable.find(currPiece->getType()) != pieceLookupTable.end());
-                newHash ^= HASH_VALUES[NUM_SQUARE_STATES 
-                    * b.convertOuterBoardIndex((i * OUTER_BOARD_SIZE) + j, cornerIndex)
-                    + pieceLookupTable.find(currPiece->getType())->second
-                    + ((currPiece->getColour() == Colour::WHITE) ? 0 : 6)];
-            }
+    for (int i = 0; i < NUM_SQUARE_STATES; ++i) {
+        //Piece codes 0-5 are white, 6-11 are black
+        auto pieces = b.pieceBoards[i];
+        while (pieces) {
+            newHash ^= HASH_VALUES[getPieceHashIndex(popLowestSquare(pieces), i % 6, i < 6)];
         }
     }
     if (b.isWhiteTurn) {
-        newHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::WHITE_MOVE)];
+        newHash ^= HASH_VALUES[HASH_WHITE_MOVE];
     }
     
-    newHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::CASTLE_RIGHTS) + b.castleRights];
+    newHash ^= CASTLE_HASH_VALUES[b.castleRights];
     
+    //The en passant target is only set when a pawn can capture it, which matches Polyglot
     if (b.enPassantActive) {
-         //Calculate en passant file
-        const auto targetIndex = std::distance(b.vectorTable.cbegin(), 
-            std::find_if(b.vectorTable.cbegin(), b.vectorTable.cend(), 
-            [&b](const auto& sq){
-                return *sq == *b.enPassantTarget;
-            }
-        ));
-        const int fileNum = Board::convertOuterBoardIndex(targetIndex, cornerIndex) % INNER_BOARD_SIZE;
-        newHash ^= HASH_VALUES[static_cast<unsigned int>(SquareState::EN_PASSANT_FILE) + fileNum];
+        newHash ^= HASH_VALUES[HASH_EN_PASSANT_FILE + getFile(b.enPassantTarget)];
     }
     return newHash;
 }
 
-size_t std::hash<Piece>::operator()(const Piece& p) const {
-    return std::hash<char>()(static_cast<char>(p.type)) ^ std::hash<char>()(static_cast<char>(p.pieceColour));
-}
-
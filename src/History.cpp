@@ -0,0 +1,38 @@
+/**
+* This is part of ChessPlusPlus, a C++14 Chess AI
+* Copyright (C) 2017 John Agapeyev
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include "headers/history.h"
+#include "headers/board.h"
+
+/**
+ * Counts how many earlier positions are identical to the board's current one, stopping at limit.
+ * A position can only recur after the last capture or pawn move, and only with the same side to move,
+ * so the history is walked back two plies at a time over the last halfMoveClock plies.
+ */
+int PositionHistory::countRepetitions(const Board& board, const int limit) const {
+    const int historySize = std::min<unsigned int>(length, MAX_HISTORY_LENGTH);
+    const int searchLength = std::min(board.getHalfMoveClock(), historySize);
+    int count = 0;
+    for (int i = 4; i <= searchLength; i += 2) {
+        if (keys[(length - i) % MAX_HISTORY_LENGTH] == board.getCurrHash() && ++count >= limit) {
+            break;
+        }
+    }
+    return count;
+}
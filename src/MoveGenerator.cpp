@@ -22,13 +22,15 @@
 #include <algorithm>
 #include <cassert>
 #include "headers/board.h"
-#include "headers/square.h"
 #include "headers/consts.h"
 #include "headers/enums.h"
 #include "headers/move.h"
+#include "headers/bitboard.h"
 
 /**
  * This method translates human text input into a move struct that can be used.
+ * If the input matches a legal move, the generated move is returned so that
+ * the castling, en passant and promotion flags are already filled in.
  */
 Move Board::MoveGenerator::createMove(std::string& input) const {
     // If the characters are letters, convert them to digit chars
@@ -43,68 +45,25 @@ Move Board::MoveGenerator::createMove(std::string& input) const {
     for (auto& ch : input) {
         ch -= '0';
     }
-    Move result;
-    const auto topLeftCornerIndex = board->findCorner_1D();
+    const Move result{makeSquare(input[1], input[0]), makeSquare(input[3], input[2])};
     
-    result.fromSq = board->vectorTable[((INNER_BOARD_SIZE - 1 - input[1]) * OUTER_BOARD_SIZE) 
-        + topLeftCornerIndex + input[0]].get();
-            
-    result.toSq = board->vectorTable[((INNER_BOARD_SIZE - 1 - input[3]) * OUTER_BOARD_SIZE) 
-        + topLeftCornerIndex + input[2]].get();
-    
-    if (result.fromSq->getPiece()) {
-        result.fromPieceType = result.fromSq->getPiece()->getType();
-        result.fromPieceColour = result.fromSq->getPiece()->getColour();
-    } else {
-        result.fromPieceType = PieceTypes::UNKNOWN;
-        result.fromPieceColour = Colour::UNKNOWN;
-    }
-    if (result.toSq->getPiece()) {
-        result.toPieceType = result.toSq->getPiece()->getType();
-        result.toPieceColour = result.toSq->getPiece()->getColour();
-        result.captureMade = true;
-    } else {
-        result.toPieceType = PieceTypes::UNKNOWN;
-        result.toPieceColour = Colour::UNKNOWN;
-        result.captureMade = false;
+    for (const auto mv : generateAll()) {
+        if (mv.getFromSq() == result.getFromSq() && mv.getToSq() == result.getToSq()) {
+            return mv;
+        }
     }
-    
-    result.promotionType = (result.fromSq->getPiece()) ? result.fromSq->getPiece()->getType() : PieceTypes::UNKNOWN;
-    result.promotionMade = false;
-    
-    result.isCastle = false;
-    result.castleRights = board->castleRights;
-    result.enPassantActive = false;
-    result.enPassantTarget = nullptr;
-    result.halfMoveClock = 0;
-    result.moveCounter = 0;
-    
     return result;
 }
- /**
-  * This method validates a given move for legality.
-  *
-  * IMPORTANT:
-  * Positive x: (30 * ((x + 7) / 15)) - x
-  * Negative x: -((30 * ((abs(x) + 7) / 15)) - abs(x))
-  * This function represents the number of spaces needed to be subtracted
-  * from 0 to reach the corresponding offset square based on the fact
-  * that the board is represented in a 1-D array with offsets increasing
-  * left to right 
-  * x is the desired offset square to find.
-  * This method is critical for part of this validation method, and as such
-  * I am commenting it here as a backup just in case the code gets altered and
-  * breaks everything.
-  */
-bool Board::MoveGenerator::validateMove(const Move& mv, const bool isSilent) {
-    // Try to find the start and end points
-    assert(!(board->getSquareIndex(mv.fromSq) == -1 || board->getSquareIndex(mv.toSq) == -1));
-    
-    // Check for either square being a sentinel
-    assert(!(mv.fromSq->checkSentinel() || mv.toSq->checkSentinel()));
-    
-    if (!mv.fromSq->getPiece() || (mv.fromPieceType == PieceTypes::UNKNOWN 
-            && mv.fromPieceColour == Colour::UNKNOWN)) {
+
+/**
+ * This method validates a given move for legality.
+ * A move is legal if it matches one of the moves generated for the current position,
+ * which is checked directly rather than by generating every move.
+ */
+bool Board::MoveGenerator::validateMove(const Move mv, const bool isSilent) const {
+    const auto fromColour = board->getPieceColour(mv.getFromSq());
+    
+    if (fromColour == Colour::UNKNOWN) {
         if (!isSilent) {
             std::cout << "Cannot start a move on an empty square\n";
         }
@@ -112,8 +71,8 @@ bool Board::MoveGenerator::validateMove(const Move& mv, const bool isSilent) {
     }
     
     // Check if piece being moved matches the current player's colour
-    if ((mv.fromPieceColour == Colour::WHITE && !board->isWhiteTurn) 
-            || (mv.fromPieceColour == Colour::BLACK && board->isWhiteTurn)) {
+    if ((fromColour == Colour::WHITE && !board->isWhiteTurn) 
+            || (fromColour == Colour::BLACK && board->isWhiteTurn)) {
         if (!isSilent) {
             if (board->isWhiteTurn) {
                 std::cout << "Cannot move black piece on white's turn\n";
@@ -128,445 +87,650 @@ bool Board::MoveGenerator::validateMove(const Move& mv, const bool isSilent) {
      * Check if the colour of the piece on the starting square 
      * is the same colour as the piece on the ending square.
      */
-    if (mv.toSq->getPiece() && mv.fromPieceColour == mv.toPieceColour) {
+    if (board->getPieceColour(mv.getToSq()) == fromColour) {
         logMoveFailure(1, isSilent);
         return false;
     }
     
     //Prevent pieces from capturing a king
-    if (mv.toPieceType == PieceTypes::KING) {
+    if (board->getPieceType(mv.getToSq()) == PieceTypes::KING) {
         logMoveFailure(2, isSilent);
         return false;
     }
     
-    // Find the offset that the move uses
-    const int selectedOffset = getMoveOffset(mv);
-
-    // Check if the move offset was found
-    if (selectedOffset == -100) {
+    if (!isPseudoLegal(mv) || !isLegal(mv)) {
         logMoveFailure(3, isSilent);
         return false;
     }
+    return true;
+}
+
+/**
+ * Checks if a given square on the board is attacked by the opponent of the given colour.
+ * This method is called primarily in regards to castling, or checking if a king is in check.
+ */
+bool Board::MoveGenerator::inCheck(const int squareIndex, const Colour friendlyColour) const {
+    return inCheck(squareIndex, friendlyColour, board->getOccupancy(), 0);
+}
+
+/**
+ * Same as above, but checks against a modified occupancy.
+ * Any enemy pieces on the removed squares are treated as captured and cannot attack.
+ */
+bool Board::MoveGenerator::inCheck(const int squareIndex, const Colour friendlyColour, 
+        const Bitboard occupancy, const Bitboard removed) const {
+    assert(squareIndex >= 0 && squareIndex < INNER_BOARD_SIZE * INNER_BOARD_SIZE);
+    return board->attackersTo(squareIndex, occupancy) & board->getColourBoard(getOppositeColour(friendlyColour)) & ~removed;
+}
+
+/**
+ * Same as above, this method performs a check for check.
+ * The difference is that this method checks whether the given move would leave
+ * the moving side's king in check.
+ */
+bool Board::MoveGenerator::inCheck(const Move mv) const {
+    const auto fromSq = mv.getFromSq();
+    const auto toSq = mv.getToSq();
+    const auto colour = board->getPieceColour(fromSq);
+    const auto isKingMove = (board->getPieceType(fromSq) == PieceTypes::KING);
+    const auto kingSquare = (isKingMove) ? toSq : board->getKingSquare(colour);
+    
+    /*
+     * If the king is not already in check, moving any other piece can only expose it
+     * when the piece starts on a line through the king.
+     */
+    if (!isKingMove && !mv.isEnPassant() && !getDeltaAttack(kingSquare, fromSq).step && !board->checkers) {
+        return false;
+    }
     
-    const auto absOffset = std::abs(selectedOffset);
+    const auto toMask = squareMask(toSq);
+    auto occupancy = (board->getOccupancy() & ~squareMask(fromSq)) | toMask;
+    auto removed = toMask;
     
-    const auto isPawnMove = (mv.fromPieceType == PieceTypes::PAWN);
-    const auto isDoublePawnMove = (isPawnMove && absOffset == 30);
+    if (mv.isEnPassant()) {
+        const auto captureMask = squareMask(toSq + ((colour == Colour::WHITE) ? -INNER_BOARD_SIZE : INNER_BOARD_SIZE));
+        occupancy &= ~captureMask;
+        removed |= captureMask;
+    }
     
-    // Define number of squares to check along the selected vector
-    const int moveLen = mv.fromSq->getPiece()->getVectorLength() + isDoublePawnMove;
+    return inCheck(kingSquare, colour, occupancy, removed);
+}
+
+void Board::MoveGenerator::logMoveFailure(const int failureNum, const bool isSilent) const {
+    if (isSilent) {
+        return;
+    }
+#ifndef NDEBUG
+    std::cout << "Move is not legal " << failureNum << '\n';
+#else
+    std::cout << "Move is not legal\n";
+#endif
+}
+
+/**
+ * Adds a pseudo-legal move to the move list if it does not leave the king in check.
+ * Only king moves and en passant captures need this, all other moves are legal by construction.
+ */
+inline void Board::MoveGenerator::addMove(const Move mv, MoveList& moveList) const {
+    if (!inCheck(mv)) {
+        moveList.push_back(mv);
+    }
+}
+
+/**
+ * Returns the pieces of the given colour that are pinned to their own king.
+ * A piece is pinned if it is the only piece standing between the king and an enemy slider
+ * that would attack the king along that line.
+ */
+Bitboard Board::MoveGenerator::getPinnedPieces(const Colour colour) const {
+    const auto enemyColour = getOppositeColour(colour);
+    const auto kingSquare = board->getKingSquare(colour);
+    const auto occupancy = board->getOccupancy();
+    const auto enemyQueens = board->getPieceBoard(PieceTypes::QUEEN, enemyColour);
     
-    auto foundToSquare = false;
+    auto snipers = (getRookAttacks(kingSquare, 0) & (board->getPieceBoard(PieceTypes::ROOK, enemyColour) | enemyQueens))
+        | (getBishopAttacks(kingSquare, 0) & (board->getPieceBoard(PieceTypes::BISHOP, enemyColour) | enemyQueens));
     
-    // Iterate through to ensure sliding pieces aren't being blocked
-    for (int i = 1; i < moveLen; ++i) {
-        const auto realIndex = getOffsetIndex(selectedOffset >> isDoublePawnMove, ZERO_LOCATION_1D, i);
-        if (realIndex < 0 || realIndex >= OUTER_BOARD_SIZE * OUTER_BOARD_SIZE) {
-            break;
+    Bitboard pinned = 0;
+    while (snipers) {
+        const auto blockers = getBetween(kingSquare, popLowestSquare(snipers)) & occupancy;
+        if (blockers && !(blockers & (blockers - 1))) {
+            pinned |= blockers & board->getColourBoard(colour);
         }
-        const auto currSquare = board->vectorTable[realIndex].get();
+    }
+    return pinned;
+}
 
-        if (*currSquare == *mv.toSq) {
-            foundToSquare = true;
-            break;
-        }
-        // Check if the square has a piece on it or is a sentinel
-        if (currSquare->getPiece()) {
-            logMoveFailure(4, isSilent);
-            return false;
-        }
+/**
+ * Returns the squares that a piece other than the king can move to without leaving its king in check.
+ * Out of a single check, a piece must either capture the checker or block it, otherwise any square will do.
+ */
+Bitboard Board::MoveGenerator::getCheckTargets() const {
+    const auto checkers = board->checkers;
+    if (!checkers) {
+        return ~Bitboard{0};
     }
-    // Check if square was found in previous loop
-    if (!foundToSquare) {
-        logMoveFailure(5, isSilent);
-        return false;
+    const auto kingSquare = board->getKingSquare((board->isWhiteTurn) ? Colour::WHITE : Colour::BLACK);
+    return getBetween(kingSquare, getLowestSquare(checkers)) | checkers;
+}
+
+/**
+ * Returns the attacks of a knight, bishop, rook, queen or king.
+ * The type is known at compile time, so the switch folds down to a single table lookup.
+ */
+template<PieceTypes type>
+static inline Bitboard getAttacks(const int square, const Bitboard occupancy) {
+    switch (type) {
+        case PieceTypes::KNIGHT:
+            return getKnightAttacks(square);
+        case PieceTypes::BISHOP:
+            return getBishopAttacks(square, occupancy);
+        case PieceTypes::ROOK:
+            return getRookAttacks(square, occupancy);
+        case PieceTypes::QUEEN:
+            return getQueenAttacks(square, occupancy);
+        case PieceTypes::KING:
+            return getKingAttacks(square);
+        default:
+            return 0;
     }
+}
+
+/**
+ * Generates the pushes, captures, en passant captures and promotions of a single pawn.
+ * Captures, en passant and every promotion belong to the capture stage, the remaining pushes to the quiet stage.
+ * Pushes and captures are restricted to the legal targets, en passant is verified separately
+ * since it removes a pawn that is not on the target square.
+ */
+template<Colour colour>
+void Board::MoveGenerator::generatePawnMoves(const int fromSquare, 
+        const Bitboard legalTargets, const GenerationType genType, MoveList& moveList) const {
+    constexpr auto isWhite = (colour == Colour::WHITE);
+    constexpr auto direction = (isWhite) ? INNER_BOARD_SIZE : -INNER_BOARD_SIZE;
+    constexpr auto startRank = (isWhite) ? 1 : 6;
+    constexpr auto promotionRank = (isWhite) ? 7 : 0;
+    const auto occupancy = board->getOccupancy();
+    const auto isPromoting = (getRank(fromSquare + direction) == promotionRank);
     
-    /* 
-     * Check that pawns don't double move except on their starting rows.
-     * Since board is 1D array, finding the pawn row can be done by counting
-     * the number of squares between the top left corner and the starting square
-     * of the selected move.
-     */
-    if (isDoublePawnMove) {
-        const auto distFromStartToCorner = board->getSquareIndex(mv.fromSq) - board->findCorner_1D();
-        const auto whiteOffset = board->isWhiteTurn * 75;
-        const auto rowPairs = std::make_pair(15 + whiteOffset, 29 + whiteOffset);
-        if (distFromStartToCorner < rowPairs.first || distFromStartToCorner > rowPairs.second) {
-            logMoveFailure(6, isSilent);
-            return false;
+    const auto addPawnMove = [&](const int toSquare, const bool isCapture) {
+        if (!(legalTargets & squareMask(toSquare))) {
+            return;
         }
-    }
+        if (!isPromoting) {
+            if (genType & ((isCapture) ? CAPTURES : QUIETS)) {
+                moveList.emplace_back(fromSquare, toSquare);
+            }
+            return;
+        }
+        if (!(genType & CAPTURES)) {
+            return;
+        }
+        moveList.emplace_back(fromSquare, toSquare, Move::PROMOTION, PieceTypes::KNIGHT);
+        moveList.emplace_back(fromSquare, toSquare, Move::PROMOTION, PieceTypes::BISHOP);
+        moveList.emplace_back(fromSquare, toSquare, Move::PROMOTION, PieceTypes::ROOK);
+        moveList.emplace_back(fromSquare, toSquare, Move::PROMOTION, PieceTypes::QUEEN);
+    };
     
-    // Pawn related validation checks
-    if (isPawnMove) {
-        // Ensure pawns only move diagonally if they capture a piece, including en passant
-        const auto distToCaptureSquare = board->getSquareIndex(mv.toSq) 
-            - OUTER_BOARD_SIZE + ((mv.fromPieceColour == Colour::WHITE) * OUTER_BOARD_SIZE << 1);
+    const auto singlePush = fromSquare + direction;
+    if (!(occupancy & squareMask(singlePush))) {
+        addPawnMove(singlePush, false);
         
-        if (selectedOffset % OUTER_BOARD_SIZE) {
-            if (!mv.toSq->getPiece() && !(board->enPassantActive && *mv.toSq == *board->enPassantTarget 
-                    && board->vectorTable[distToCaptureSquare]->getPiece()
-                    && board->vectorTable[distToCaptureSquare]->getPiece()->getColour() != mv.fromPieceColour)) {
-                logMoveFailure(7, isSilent);
-                return false;
-            }
-        } else if (mv.toSq->getPiece()) {
-            // Prevent pawns from capturing vertically
-            logMoveFailure(8, isSilent);
-            return false;
+        const auto doublePush = singlePush + direction;
+        if (getRank(fromSquare) == startRank && !(occupancy & squareMask(doublePush))) {
+            addPawnMove(doublePush, false);
         }
     }
     
-    //Prevent players from placing their own king in check
-    if (inCheck(mv)) {
-        logMoveFailure(9, isSilent);
-        return false;
+    if (!(genType & CAPTURES)) {
+        return;
+    }
+    
+    const auto attacks = getPawnAttacks(fromSquare, colour);
+    auto captures = attacks & board->getColourBoard(getOppositeColour(colour));
+    
+    while (captures) {
+        addPawnMove(popLowestSquare(captures), true);
+    }
+    
+    if (board->enPassantActive && (attacks & squareMask(board->enPassantTarget))) {
+        addMove(Move(fromSquare, board->enPassantTarget, Move::EN_PASSANT), moveList);
     }
+}
+
+/**
+ * Generates the moves of every knight, bishop, rook or queen of one colour.
+ * The targets already combine the stage, check and friendly piece restrictions,
+ * so only pinned pieces need any further masking.
+ */
+template<Colour colour, PieceTypes type>
+void Board::MoveGenerator::generatePieceMoves(const Bitboard targets, const Bitboard pinned, MoveList& moveList) const {
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    auto pieces = board->getPieceBoard(type, colour);
     
-    if (mv.fromPieceType == PieceTypes::KING && absOffset == 2) {
-        // Prevent king from jumping 2 spaces if not castling
-        if (!getCastleDirectionBool(mv.fromPieceType, mv.fromPieceColour, selectedOffset)) {
-            logMoveFailure(10, isSilent);
-            return false;
+    while (pieces) {
+        const auto fromSquare = popLowestSquare(pieces);
+        auto pieceTargets = getAttacks<type>(fromSquare, occupancy) & targets;
+        
+        //A pinned piece can only move along the line between its king and the pinning piece
+        if (pinned & squareMask(fromSquare)) {
+            pieceTargets &= getLine(kingSquare, fromSquare);
         }
-        //Prevent castling if king is currently in check
-        if ((mv.fromPieceColour == Colour::BLACK && board->blackInCheck) 
-                || (mv.fromPieceColour == Colour::WHITE && board->whiteInCheck)) {
-            logMoveFailure(11, isSilent);
-            return false;
+        while (pieceTargets) {
+            moveList.emplace_back(fromSquare, popLowestSquare(pieceTargets));
         }
-        const bool isKingSide = (selectedOffset > 0);
-        const auto currIndex = board->getSquareIndex(mv.fromSq);
+    }
+}
 
-        const auto rookSquare = board->vectorTable[currIndex - 3 + (isKingSide * 3 << 1) - !isKingSide]->getPiece();
-        if (!rookSquare || rookSquare->getType() != PieceTypes::ROOK 
-                || rookSquare->getColour() != (board->isWhiteTurn ? Colour::WHITE : Colour::BLACK)) {
-            logMoveFailure(12, isSilent); 
-            return false;
-        }
+/**
+ * Checks whether the given player can currently castle to one side.
+ * The king and rook must be on their starting squares with the rights intact, the squares between
+ * them must be empty, and the king cannot castle out of, through, or into check.
+ */
+bool Board::MoveGenerator::canCastle(const Colour colour, const bool isKingSide) const {
+    const auto isWhite = (colour == Colour::WHITE);
+    const auto flag = (isKingSide) 
+        ? ((isWhite) ? WHITE_CASTLE_KING_FLAG : BLACK_CASTLE_KING_FLAG) 
+        : ((isWhite) ? WHITE_CASTLE_QUEEN_FLAG : BLACK_CASTLE_QUEEN_FLAG);
+    const auto kingSquare = (isWhite) ? 4 : 60;
+    const auto rookSquare = kingSquare + ((isKingSide) ? 3 : -4);
+    const auto step = (isKingSide) ? 1 : -1;
+    
+    return (board->castleRights & flag) && !board->checkers
+        && (board->getPieceBoard(PieceTypes::KING, colour) & squareMask(kingSquare))
+        && (board->getPieceBoard(PieceTypes::ROOK, colour) & squareMask(rookSquare))
+        && !(board->getOccupancy() & getBetween(kingSquare, rookSquare))
+        && !inCheck(kingSquare + step, colour) && !inCheck(kingSquare + (2 * step), colour);
+}
 
-        for (int i = 1; i <= 2 + !isKingSide; ++i) {
-            const auto index = -i + (isKingSide * i << 1);
-            const auto currPiece = board->vectorTable[currIndex + index]->getPiece();
-            const auto checkIndex = currIndex + index;
-            //Prevent castling if the squares are not empty, there is no rook in the corner, or the in-between squares are under attack
-            if ((currPiece && currPiece->getType() != PieceTypes::ROOK) || (i <= 2 && inCheck(checkIndex))) {
-                logMoveFailure(13, isSilent);
-                return false;
-            }
-        }
+/**
+ * Generates the castling moves available to the current player.
+ */
+void Board::MoveGenerator::generateCastling(const Colour colour, MoveList& moveList) const {
+    const auto kingSquare = (colour == Colour::WHITE) ? 4 : 60;
+    if (canCastle(colour, true)) {
+        moveList.emplace_back(kingSquare, kingSquare + 2, Move::CASTLE);
+    }
+    if (canCastle(colour, false)) {
+        moveList.emplace_back(kingSquare, kingSquare - 2, Move::CASTLE);
     }
-    return true;
 }
 
 /**
- * Checks if a given square on the board is in check.
- * This method is called primarily in regards to castling, or checking if a king is in check
+ * Shared generation routine behind all of the public generation functions.
+ * The generation type selects captures (including promotions), quiet moves (including castling), or both.
+ * If isLegalOnly is set, check evasions and pins are worked out once up front, so every piece other
+ * than the king only generates moves that are already known to be legal.
+ * Otherwise the generated moves are pseudo-legal and must pass isLegal before they are made.
+ * En passant and castling are always verified, as they are rare and awkward to check later.
  */
-bool Board::MoveGenerator::inCheck(const int squareIndex) const {
-    assert(squareIndex >= 0 && squareIndex < TOTAL_BOARD_SIZE);
+template<Colour colour>
+void Board::MoveGenerator::generateMoves(const GenerationType genType, const bool isLegalOnly, MoveList& moveList) const {
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    const auto checkers = board->checkers;
     
-    static const auto& checkVectors{Piece(PieceTypes::UNKNOWN, Colour::UNKNOWN).getVectorList()};
-    const int cornerIndex =  board->findCorner_1D();
+    //Squares that moves of the requested type can land on
+    const auto stageTargets = ((genType & CAPTURES) ? board->getColourBoard(getOppositeColour(colour)) : 0)
+        | ((genType & QUIETS) ? ~occupancy : 0);
     
-    /*
-     * If square is empty, AKA castling validity check, set friendly colour 
-     * based on which half of the board the square is.
-     */
-    Colour friendlyPieceColour;
-    if (!board->vectorTable[squareIndex]->getPiece()) {
-        friendlyPieceColour = (squareIndex - cornerIndex >= 52) ? Colour::WHITE : Colour::BLACK;
-    } else {
-        friendlyPieceColour = board->vectorTable[squareIndex]->getPiece()->getColour();
+    const auto addKingMoves = [&]() {
+        auto targets = getKingAttacks(kingSquare) & stageTargets;
+        while (targets) {
+            const Move mv{kingSquare, popLowestSquare(targets)};
+            if (isLegalOnly) {
+                addMove(mv, moveList);
+            } else {
+                moveList.push_back(mv);
+            }
+        }
+    };
+    
+    //Only the king can move out of a double check
+    if (isLegalOnly && (checkers & (checkers - 1))) {
+        addKingMoves();
+        return;
     }
     
-    int vectorLength = 7;
-    for (const auto offset : checkVectors) {
-        const auto absOffset = std::abs(offset);
-        // Change depth if current offset is a knight offset
-        vectorLength = 7 - ((absOffset == 13 || absOffset > 16) * 6);
+    const auto checkTargets = (isLegalOnly) ? getCheckTargets() : ~Bitboard{0};
+    const auto pinned = (isLegalOnly) ? getPinnedPieces(colour) : 0;
+    
+    auto pawns = board->getPieceBoard(PieceTypes::PAWN, colour);
+    while (pawns) {
+        const auto fromSquare = popLowestSquare(pawns);
         
-        for (int i = 1; i <= vectorLength; ++i) {
-            const auto realIndex = getOffsetIndex(offset, squareIndex, i);
-            if (realIndex < 0 || realIndex >= TOTAL_BOARD_SIZE) {
-                break;
-            }
-            const auto currPiece = board->vectorTable[realIndex]->getPiece();
-            if (currPiece) {
-                if (currPiece->getColour() == friendlyPieceColour 
-                        || currPiece->getColour() == Colour::UNKNOWN) {
-                    break;
-                }
-                if (i > currPiece->getVectorLength() - 1) {
-                    break;
-                }
-                if (currPiece->getType() == PieceTypes::PAWN && (offset % OUTER_BOARD_SIZE) == 0) {
-                    break;
-                }
-                const auto& pieceVector = currPiece->getVectorList();
-                bool offsetFound = false;
-                for (size_t j = 0; j < pieceVector.size(); ++j) {
-                    if (pieceVector[j] == -offset) {
-                        offsetFound = true;
-                        break;
-                    }
-                }
-                if (!offsetFound) {
-                    break;
-                }
-                return true;
-            }
-        }
+        //A pinned pawn can only move along the line between its king and the pinning piece
+        const auto legalTargets = (pinned & squareMask(fromSquare)) 
+            ? checkTargets & getLine(kingSquare, fromSquare) : checkTargets;
+        generatePawnMoves<colour>(fromSquare, legalTargets, genType, moveList);
+    }
+    
+    const auto pieceTargets = stageTargets & checkTargets;
+    generatePieceMoves<colour, PieceTypes::KNIGHT>(pieceTargets, pinned, moveList);
+    generatePieceMoves<colour, PieceTypes::BISHOP>(pieceTargets, pinned, moveList);
+    generatePieceMoves<colour, PieceTypes::ROOK>(pieceTargets, pinned, moveList);
+    generatePieceMoves<colour, PieceTypes::QUEEN>(pieceTargets, pinned, moveList);
+    addKingMoves();
+    
+    if (genType & QUIETS) {
+        generateCastling(colour, moveList);
     }
-    return false;
 }
 
 /**
- * Same as above, this method performs a check for check.
- * The difference is that this method validates a given move instead of a square index due to the requirements
- * of checking the pieces and square involved.
+ * Dispatches to the generation routine of the current player.
+ * The colour is only checked here, once per call, rather than throughout generation.
  */
-bool Board::MoveGenerator::inCheck(const Move& mv) const {
-    static const auto& checkVectors = Piece(PieceTypes::UNKNOWN, Colour::UNKNOWN).getVectorList();
-    std::unique_ptr<Piece> toPieceCopy{mv.toSq->releasePiece()};
-    bool enPassantCaptureMade = false;
-    int captureIndex = -1;
-    std::unique_ptr<Piece> enPassantPiece{nullptr};
-
-    if (mv.enPassantActive && mv.fromPieceType == PieceTypes::PAWN && mv.toSq == mv.enPassantTarget
-            && ((mv.toSq->getOffset() - mv.fromSq->getOffset()) % OUTER_BOARD_SIZE)) {
-        enPassantCaptureMade = true;
-        captureIndex = board->getSquareIndex(mv.toSq) - OUTER_BOARD_SIZE + ((board->isWhiteTurn) * OUTER_BOARD_SIZE << 1);
-        enPassantPiece.reset(board->vectorTable[captureIndex]->releasePiece());
+void Board::MoveGenerator::generateMoves(const GenerationType genType, const bool isLegalOnly, MoveList& moveList) const {
+    if (board->isWhiteTurn) {
+        generateMoves<Colour::WHITE>(genType, isLegalOnly, moveList);
+    } else {
+        generateMoves<Colour::BLACK>(genType, isLegalOnly, moveList);
     }
+}
 
-    std::swap(*mv.fromSq, *mv.toSq);
+/**
+ * This function generates all legal moves for the current position.
+ */
+MoveList Board::MoveGenerator::generateAll() const {
+    MoveList moveList;
+    generateMoves(ALL, true, moveList);
+    return moveList;
+}
 
-    //Check if friendly king can be found
-    assert(std::find_if(board->vectorTable.cbegin(), board->vectorTable.cend(), 
-            [&](const auto& sq){
-                const auto& piece = sq->getPiece();
-                return piece && piece->getType() == PieceTypes::KING 
-                    && piece->getColour() == mv.fromPieceColour;
-            }) != board->vectorTable.cend());
-            
-    int squareIndex = -1;
-    for (size_t i = 0; i < TOTAL_BOARD_SIZE; ++i) {
-        const auto& piece = board->vectorTable[i]->getPiece();
-        if (piece && piece->getType() == PieceTypes::KING && piece->getColour() == mv.fromPieceColour) {
-            squareIndex = i;
-            break;
+/**
+ * Generates all pseudo-legal moves for the current position.
+ */
+MoveList Board::MoveGenerator::generatePseudo() const {
+    MoveList moveList;
+    generateMoves(ALL, false, moveList);
+    return moveList;
+}
+
+/**
+ * Generates the pseudo-legal captures, en passant captures and promotions for the current position.
+ * This is the first stage of staged generation, and all a quiescence search needs.
+ */
+MoveList Board::MoveGenerator::generateCaptures() const {
+    MoveList moveList;
+    generateMoves(CAPTURES, false, moveList);
+    return moveList;
+}
+
+/**
+ * Generates the pseudo-legal non-capturing moves that are not promotions, including castling.
+ * Together with generateCaptures this covers every pseudo-legal move exactly once.
+ */
+MoveList Board::MoveGenerator::generateQuiets() const {
+    MoveList moveList;
+    generateMoves(QUIETS, false, moveList);
+    return moveList;
+}
+
+/**
+ * Generates the legal replies to a check.
+ * Only valid when the current player is in check.
+ */
+MoveList Board::MoveGenerator::generateEvasions() const {
+    MoveList moveList;
+    assert(board->checkers);
+    generateMoves(ALL, true, moveList);
+    return moveList;
+}
+
+/**
+ * Counts the moves of every knight, bishop, rook or queen of one colour, with the same masking as generatePieceMoves.
+ */
+template<Colour colour, PieceTypes type>
+int Board::MoveGenerator::countPieceMoves(const Bitboard targets, const Bitboard pinned) const {
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    auto pieces = board->getPieceBoard(type, colour);
+    int count = 0;
+    
+    while (pieces) {
+        const auto fromSquare = popLowestSquare(pieces);
+        auto pieceTargets = getAttacks<type>(fromSquare, occupancy) & targets;
+        if (pinned & squareMask(fromSquare)) {
+            pieceTargets &= getLine(kingSquare, fromSquare);
         }
+        count += popCount(pieceTargets);
     }
-    //Ensure index was found during previous loop
-    assert(squareIndex != -1);
+    return count;
+}
+
+/**
+ * Counts the legal moves of one player without generating them.
+ * Target squares are counted straight from the attack sets, with each promotion counting as four moves.
+ */
+template<Colour colour>
+int Board::MoveGenerator::countLegalMoves() const {
+    constexpr auto isWhite = (colour == Colour::WHITE);
+    const auto friendlyPieces = board->getColourBoard(colour);
+    const auto enemyPieces = board->getColourBoard(getOppositeColour(colour));
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    const auto checkers = board->checkers;
     
-    int vectorLength;
-    for (const auto offset : checkVectors) {
-        const auto absOffset = std::abs(offset);
-        // Change depth if current offset is a knight offset
-        vectorLength = 7 - ((absOffset == 13 || absOffset > 16) * 6);
+    int count = 0;
+    
+    //The king cannot block its own attackers, so it is removed before testing its target squares
+    auto kingTargets = getKingAttacks(kingSquare) & ~friendlyPieces;
+    const auto occupancyWithoutKing = occupancy & ~squareMask(kingSquare);
+    while (kingTargets) {
+        count += !(board->attackersTo(popLowestSquare(kingTargets), occupancyWithoutKing) & enemyPieces);
+    }
+    
+    //Only the king can move out of a double check
+    if (checkers & (checkers - 1)) {
+        return count;
+    }
+    
+    const auto checkTargets = getCheckTargets();
+    const auto pinned = getPinnedPieces(colour);
+    const auto pieceTargets = ~friendlyPieces & checkTargets;
+    
+    count += countPieceMoves<colour, PieceTypes::KNIGHT>(pieceTargets, pinned);
+    count += countPieceMoves<colour, PieceTypes::BISHOP>(pieceTargets, pinned);
+    count += countPieceMoves<colour, PieceTypes::ROOK>(pieceTargets, pinned);
+    count += countPieceMoves<colour, PieceTypes::QUEEN>(pieceTargets, pinned);
+    
+    constexpr auto direction = (isWhite) ? INNER_BOARD_SIZE : -INNER_BOARD_SIZE;
+    constexpr auto startRank = (isWhite) ? 1 : 6;
+    constexpr auto promotionRank = (isWhite) ? RANK_8_MASK : RANK_1_MASK;
+    
+    auto pawns = board->getPieceBoard(PieceTypes::PAWN, colour);
+    while (pawns) {
+        const auto fromSquare = popLowestSquare(pawns);
+        const auto attacks = getPawnAttacks(fromSquare, colour);
+        auto targets = attacks & enemyPieces;
         
-        for (int i = 1; i <= vectorLength; ++i) {
-            const auto realIndex = getOffsetIndex(offset, squareIndex, i);
-            if (realIndex < 0 || realIndex >= TOTAL_BOARD_SIZE) {
-                break;
-            }
-            const auto currPiece = board->vectorTable[realIndex]->getPiece();
-            if (currPiece) {
-                if (currPiece->getColour() == mv.fromPieceColour 
-                        || currPiece->getColour() == Colour::UNKNOWN) {
-                    break;
-                }
-
-                //Prevent single space mover pieces from being treated as sliding pieces
-                if (i > currPiece->getVectorLength() - 1) {
-                    break;
-                }
-                if (currPiece->getType() == PieceTypes::PAWN && (offset % OUTER_BOARD_SIZE) == 0) {
-                    break;
-                }
-                const auto& pieceVector = currPiece->getVectorList();
-                bool offsetFound = false;
-                for (size_t j = 0; j < pieceVector.size(); ++j) {
-                    if (pieceVector[j] == -offset) {
-                        offsetFound = true;
-                        break;
-                    }
-                }
-                if (!offsetFound) {
-                    break;
-                }
-                std::swap(*mv.fromSq, *mv.toSq);
-                if (mv.captureMade) {
-                    mv.toSq->setPiece(std::move(toPieceCopy));
-                }
-                if (enPassantCaptureMade) {
-                    board->vectorTable[captureIndex]->setPiece(std::move(enPassantPiece));
-                }
-                return true;
+        const auto singlePush = fromSquare + direction;
+        if (!(occupancy & squareMask(singlePush))) {
+            targets |= squareMask(singlePush);
+            if (getRank(fromSquare) == startRank && !(occupancy & squareMask(singlePush + direction))) {
+                targets |= squareMask(singlePush + direction);
             }
         }
+        
+        targets &= checkTargets;
+        if (pinned & squareMask(fromSquare)) {
+            targets &= getLine(kingSquare, fromSquare);
+        }
+        count += popCount(targets & ~promotionRank) + (4 * popCount(targets & promotionRank));
+        
+        if (board->enPassantActive && (attacks & squareMask(board->enPassantTarget)) 
+                && !inCheck(Move(fromSquare, board->enPassantTarget, Move::EN_PASSANT))) {
+            ++count;
+        }
     }
-    std::swap(*mv.fromSq, *mv.toSq);
-    if (mv.captureMade) {
-        mv.toSq->setPiece(std::move(toPieceCopy));
-    }
-    if (enPassantCaptureMade) {
-        board->vectorTable[captureIndex]->setPiece(std::move(enPassantPiece));
-    }
-    return false;
+    
+    return count + canCastle(colour, true) + canCastle(colour, false);
 }
 
 /**
- * Checks if a piece can castle based on the offset it is moving.
- * It checks the given values against the castle rights and returns whether
- * castling rights are allowed or not for the given input.
+ * Checks whether any knight, bishop, rook or queen of one colour has a move, with the same masking as generatePieceMoves.
  */
-bool Board::MoveGenerator::getCastleDirectionBool(const PieceTypes type, 
-        const Colour pieceColour, const int offset) const {
-    if (type == PieceTypes::KING && std::abs(offset) == 2) {
-        if (pieceColour == Colour::WHITE) {
-            return board->castleRights & ((offset < 0) ? WHITE_CASTLE_QUEEN_FLAG : WHITE_CASTLE_KING_FLAG);
+template<Colour colour, PieceTypes type>
+bool Board::MoveGenerator::hasPieceMove(const Bitboard targets, const Bitboard pinned) const {
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    auto pieces = board->getPieceBoard(type, colour);
+    
+    while (pieces) {
+        const auto fromSquare = popLowestSquare(pieces);
+        auto pieceTargets = getAttacks<type>(fromSquare, occupancy) & targets;
+        if (pinned & squareMask(fromSquare)) {
+            pieceTargets &= getLine(kingSquare, fromSquare);
+        }
+        if (pieceTargets) {
+            return true;
         }
-        return board->castleRights & ((offset < 0) ? BLACK_CASTLE_QUEEN_FLAG : BLACK_CASTLE_KING_FLAG);
     }
     return false;
 }
 
-void Board::MoveGenerator::logMoveFailure(const int failureNum, const bool isSilent) const {
-    if (isSilent) {
-        return;
-    }
-#ifndef NDEBUG
-    std::cout << "Move is not legal " << failureNum << '\n';
-#else
-    std::cout << "Move is not legal\n";
-#endif
-}
-
 /**
- * This function generates all legal moves for the current position.
+ * Checks whether one player has any legal move, stopping at the first one found.
+ * King moves are tried first since they are the most likely to exist, and need no pin or check masks.
+ * Castling is never needed, as a legal castle implies the king can also step onto the square it passes through.
  */
-std::vector<Move> Board::MoveGenerator::generateAll() {
-    moveList.clear();
-    pieceCoords.clear();
-
-    const auto currentPlayerColour = (board->isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
-    const auto startCoords = board->findCorner();
-    
-    for (int i = 0; i < INNER_BOARD_SIZE; ++i) {
-        for (int j = 0; j < INNER_BOARD_SIZE; ++j) {
-            const auto sq = board->vectorTable[((i + startCoords.first) * OUTER_BOARD_SIZE) + j + startCoords.second].get();
-            assert(sq != nullptr);
-            const auto fromPiece = sq->getPiece();
-            if (fromPiece && fromPiece->getType() != PieceTypes::UNKNOWN 
-                    && fromPiece->getColour() == currentPlayerColour) {
-                pieceCoords.emplace_back(std::forward_as_tuple(i, j, fromPiece));
-            }
+template<Colour colour>
+bool Board::MoveGenerator::hasLegalMove() const {
+    constexpr auto isWhite = (colour == Colour::WHITE);
+    const auto friendlyPieces = board->getColourBoard(colour);
+    const auto enemyPieces = board->getColourBoard(getOppositeColour(colour));
+    const auto occupancy = board->getOccupancy();
+    const auto kingSquare = board->getKingSquare(colour);
+    const auto checkers = board->checkers;
+    
+    auto kingTargets = getKingAttacks(kingSquare) & ~friendlyPieces;
+    const auto occupancyWithoutKing = occupancy & ~squareMask(kingSquare);
+    while (kingTargets) {
+        if (!(board->attackersTo(popLowestSquare(kingTargets), occupancyWithoutKing) & enemyPieces)) {
+            return true;
         }
     }
     
-    Move mv;
-    for (const auto& p : pieceCoords) {
-        board->shiftBoard(std::get<1>(p), std::get<0>(p));
-        for (const auto offset : std::get<2>(p)->getVectorList()) {
-             //Define number of squares to check along the selected vector
-            const auto moveLen = std::get<2>(p)->getVectorLength();
-            
-            for (int j = 1; j < moveLen; ++j) {
-                const auto toSquareIndex = getOffsetIndex(offset, ZERO_LOCATION_1D, j);
-                if (toSquareIndex < 0 || toSquareIndex > TOTAL_BOARD_SIZE) {
-                    break;
-                }
-                mv.fromSq = board->vectorTable[ZERO_LOCATION_1D].get();
-                mv.toSq = board->vectorTable[toSquareIndex].get();
-
-                if (mv.toSq->checkSentinel()) {
-                    break;
-                }
-                mv.fromPieceType = mv.fromSq->getPiece()->getType();
-                mv.fromPieceColour = mv.fromSq->getPiece()->getColour();
-                
-                if (mv.toSq->getPiece()) {
-                    mv.toPieceType = mv.toSq->getPiece()->getType();
-                    mv.toPieceColour = mv.toSq->getPiece()->getColour();
-                    mv.captureMade = true;
-                    if (mv.fromPieceColour == mv.toPieceColour) {
-                        break;
-                    }
-                } else {
-                    mv.toPieceType = PieceTypes::UNKNOWN;
-                    mv.toPieceColour = Colour::UNKNOWN;
-                    mv.captureMade = false;
-                }
-
-                mv.promotionType = (mv.fromSq->getPiece()) ? mv.fromPieceType : PieceTypes::UNKNOWN;
-                mv.promotionMade = false;
-                mv.halfMoveClock = board->halfMoveClock;
-                mv.moveCounter = board->moveCounter;
-                mv.castleRights = board->castleRights;
-                mv.isCastle = false; //Let the make move function set this to its true value
-                
-                mv.enPassantActive = board->enPassantActive;
-                mv.enPassantTarget = board->enPassantTarget;
-
-                //Promotion check
-                if (mv.promotionType == PieceTypes::PAWN) {
-                    const auto distToEndSquare = board->getSquareIndex(mv.toSq);
-                            
-                    //Calculate the corner index based on the above b shift to prevent a linear search
-                    const auto cornerIndex = ((7 - std::get<0>(p)) * OUTER_BOARD_SIZE) + (7 - std::get<1>(p));
-                    const auto distFromStartToCorner = distToEndSquare - cornerIndex;
-                    const auto blackOffset = !board->isWhiteTurn * 105;
-                    const auto rowPairs = std::make_pair(0 + blackOffset, 14 + blackOffset);
-                    
-                    //Promotion validity
-                    if (distFromStartToCorner >= rowPairs.first && distFromStartToCorner <= rowPairs.second) {
-                        if (!validateMove(mv, true)) {
-                            continue;
-                        }
-                        
-                        mv.promotionType = PieceTypes::KNIGHT;
-                        moveList.push_back(mv);
-                        mv.promotionType = PieceTypes::BISHOP;
-                        moveList.push_back(mv);
-                        mv.promotionType = PieceTypes::ROOK;
-                        moveList.push_back(mv);
-                        mv.promotionType = PieceTypes::QUEEN;
-                        moveList.push_back(mv);
-                        continue;
-                    }
-                }
-                if (!validateMove(mv, true)) {
-                    continue;
-                }
-                moveList.push_back(std::move(mv));
+    if (checkers & (checkers - 1)) {
+        return false;
+    }
+    
+    const auto checkTargets = getCheckTargets();
+    const auto pinned = getPinnedPieces(colour);
+    const auto pieceTargets = ~friendlyPieces & checkTargets;
+    
+    if (hasPieceMove<colour, PieceTypes::KNIGHT>(pieceTargets, pinned) 
+            || hasPieceMove<colour, PieceTypes::BISHOP>(pieceTargets, pinned)
+            || hasPieceMove<colour, PieceTypes::ROOK>(pieceTargets, pinned) 
+            || hasPieceMove<colour, PieceTypes::QUEEN>(pieceTargets, pinned)) {
+        return true;
+    }
+    
+    constexpr auto direction = (isWhite) ? INNER_BOARD_SIZE : -INNER_BOARD_SIZE;
+    constexpr auto startRank = (isWhite) ? 1 : 6;
+    
+    auto pawns = board->getPieceBoard(PieceTypes::PAWN, colour);
+    while (pawns) {
+        const auto fromSquare = popLowestSquare(pawns);
+        const auto attacks = getPawnAttacks(fromSquare, colour);
+        auto targets = attacks & enemyPieces;
+        
+        const auto singlePush = fromSquare + direction;
+        if (!(occupancy & squareMask(singlePush))) {
+            targets |= squareMask(singlePush);
+            if (getRank(fromSquare) == startRank && !(occupancy & squareMask(singlePush + direction))) {
+                targets |= squareMask(singlePush + direction);
             }
         }
+        
+        targets &= checkTargets;
+        if (pinned & squareMask(fromSquare)) {
+            targets &= getLine(kingSquare, fromSquare);
+        }
+        if (targets) {
+            return true;
+        }
+        
+        if (board->enPassantActive && (attacks & squareMask(board->enPassantTarget)) 
+                && !inCheck(Move(fromSquare, board->enPassantTarget, Move::EN_PASSANT))) {
+            return true;
+        }
     }
-    return moveList;
+    return false;
 }
 
 /**
- * Due to the vector based nature of the board layout this chess engine uses, it's important
- * to know what vector offset a given move is using.
- * This function uses the differences in square offset values to determine the offset, which can
- * then be used for move validation.
+ * Checks whether the current player has any legal move, without counting or generating them.
+ * This is all that checkmate and stalemate detection needs.
  */
-int Board::MoveGenerator::getMoveOffset(const Move& mv) const {
-    assert(mv.fromSq && mv.toSq);
-    assert(mv.fromSq->getPiece());
-    const auto& vectorOffsets = mv.fromSq->getPiece()->getVectorList();
-    const auto vectorLength = mv.fromSq->getPiece()->getVectorLength();
-    const auto diff = mv.toSq->getOffset() - mv.fromSq->getOffset();
-    
-    // Find the offset that the move uses
-    for (const auto offset : vectorOffsets) {
-        if ((diff / offset) > 0 && (diff / offset) < vectorLength && !(diff % offset)) {
-            return offset;
-        }
+bool Board::MoveGenerator::hasLegalMove() const {
+    return (board->isWhiteTurn) ? hasLegalMove<Colour::WHITE>() : hasLegalMove<Colour::BLACK>();
+}
+
+/**
+ * Counts the legal moves in the current position without generating them.
+ * This matches the size of generateAll, and is used wherever only the number of moves matters.
+ */
+int Board::MoveGenerator::countLegalMoves() const {
+    return (board->isWhiteTurn) ? countLegalMoves<Colour::WHITE>() : countLegalMoves<Colour::BLACK>();
+}
+
+/**
+ * Checks whether a pseudo-legal move for the current player leaves their king in check.
+ */
+bool Board::MoveGenerator::isLegal(const Move mv) const {
+    return mv.isCastle() || !inCheck(mv);
+}
+
+/**
+ * Checks whether a move could have been generated by generatePseudo in the current position,
+ * without generating any moves.
+ * This is used to verify moves taken from the transposition table, which may come from a hash collision.
+ */
+bool Board::MoveGenerator::isPseudoLegal(const Move mv) const {
+    const auto colour = (board->isWhiteTurn) ? Colour::WHITE : Colour::BLACK;
+    const auto isWhite = (colour == Colour::WHITE);
+    const auto fromSq = mv.getFromSq();
+    const auto toSq = mv.getToSq();
+    const auto friendlyPieces = board->getColourBoard(colour);
+    const auto occupancy = board->getOccupancy();
+    const auto type = board->getPieceType(fromSq);
+    
+    if (!(friendlyPieces & squareMask(fromSq)) || (friendlyPieces & squareMask(toSq)) 
+            || board->getPieceType(toSq) == PieceTypes::KING) {
+        return false;
+    }
+    
+    if (mv.isCastle()) {
+        return type == PieceTypes::KING && fromSq == ((isWhite) ? 4 : 60)
+            && ((toSq == fromSq + 2 && canCastle(colour, true)) || (toSq == fromSq - 2 && canCastle(colour, false)));
+    }
+    
+    //Pieces that cannot reach the target on an empty board are rejected up front, sliders then only check their one path
+    if (type != PieceTypes::PAWN) {
+        return mv.getFlag() == Move::NORMAL && (getDeltaAttack(fromSq, toSq).pieceTypes & getPieceTypeBit(type))
+            && !(occupancy & getBetween(fromSq, toSq));
+    }
+    
+    const auto attacks = getPawnAttacks(fromSq, colour);
+    if (mv.isEnPassant()) {
+        return board->enPassantActive && toSq == board->enPassantTarget && (attacks & squareMask(toSq)) && isLegal(mv);
+    }
+    
+    //Pawn moves to the last rank must be promotions, and promotions cannot happen anywhere else
+    if (mv.isPromotion() != (getRank(toSq) == ((isWhite) ? 7 : 0))) {
+        return false;
+    }
+    
+    if (attacks & board->getColourBoard(getOppositeColour(colour)) & squareMask(toSq)) {
+        return true;
+    }
+    
+    const auto direction = (isWhite) ? INNER_BOARD_SIZE : -INNER_BOARD_SIZE;
+    if (toSq == fromSq + direction) {
+        return !(occupancy & squareMask(toSq));
     }
-    return -100;
+    return toSq == fromSq + (2 * direction) && getRank(fromSq) == ((isWhite) ? 1 : 6)
+        && !(occupancy & (squareMask(fromSq + direction) | squareMask(toSq)));
 }
@@ -27,6 +27,7 @@
 #include <condition_variable>
 #include "move.h"
 #include "board.h"
+#include "history.h"
 #include "tt.h"
 #include "consts.h"
 
@@ -34,6 +35,37 @@
 #define CACHE_MB 4096
 #endif
 
+/*
+ * Size of the evaluation cache in megabytes, which must be a power of two.
+ */
+#ifndef EVAL_CACHE_MB
+#define EVAL_CACHE_MB 16
+#endif
+
+/*
+ * When enabled, the AI prints the evaluation cache hit rate and memory use after every search.
+ */
+#ifndef EVAL_CACHE_STATS
+#define EVAL_CACHE_STATS 0
+#endif
+
+/*
+ * When enabled, the search generates pseudo-legal moves and only checks the legality of
+ * the moves it actually searches, instead of generating fully legal move lists.
+ */
+#ifndef PSEUDO_LEGAL_SEARCH
+#define PSEUDO_LEGAL_SEARCH 1
+#endif
+
+/*
+ * When enabled, search and perft build each child position in a copy of the board
+ * instead of making and unmaking moves on a single board.
+ * A board copy is only the 240 byte position, so both modes run at about the same speed.
+ */
+#ifndef COPY_MAKE_SEARCH
+#define COPY_MAKE_SEARCH 0
+#endif
+
 /**
  * This class handles all AI related behaviour.
  * It operates on top of a board instance upon which it will search
@@ -63,26 +95,70 @@ class AI {
     static constexpr auto HALF_OPEN_FILE_VAL = 10;
     static constexpr auto ROOK_SEVEN_VAL = 10;
     
-    static std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>> initializeMap();
-    static const std::unordered_multimap<Piece, std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>> pieceSquareTables;
+    using PieceSquareTable = std::array<int, INNER_BOARD_SIZE * INNER_BOARD_SIZE>;
+    static PieceSquareTable mirrorTable(const PieceSquareTable& table);
+    static std::array<PieceSquareTable, NUM_SQUARE_STATES> initializePieceSquareTables();
+    static std::array<PieceSquareTable, 2> initializeKingEndGameTables();
+    static const std::array<PieceSquareTable, NUM_SQUARE_STATES> pieceSquareTables;
+    static const std::array<PieceSquareTable, 2> kingEndGameTables;
+
+    /**
+     * Cached pawn structure terms for one set of pawns, keyed by the board's pawn hash.
+     * The score is from white's perspective, and the file masks mark the files holding pawns of each colour.
+     */
+    struct PawnEntry {
+        size_t key = 0;
+        int score = 0;
+        std::array<uint8_t, 2> fileMasks{};
+        bool valid = false;
+    };
+    static constexpr size_t PAWN_TABLE_SIZE = 1 << 14;
+    using PawnTable = std::array<PawnEntry, PAWN_TABLE_SIZE>;
+    //Each search thread keeps its own pawn table, so no locking is needed, and allocates it on its first probe
+    static thread_local std::unique_ptr<PawnTable> pawnTable;
+
+    /**
+     * Static evaluation of one position, shared between all search threads without locking.
+     * The first word stores the position hash xor'd with the data word, so an entry torn by
+     * concurrent writes fails the key check instead of returning another position's score.
+     */
+    struct EvalEntry {
+        std::atomic<uint64_t> checkedKey{0};
+        std::atomic<uint64_t> data{0};
+    };
+    static constexpr size_t EVAL_CACHE_SIZE = (static_cast<size_t>(EVAL_CACHE_MB) << 20ul) / sizeof(EvalEntry);
+    static_assert(EVAL_CACHE_SIZE && !(EVAL_CACHE_SIZE & (EVAL_CACHE_SIZE - 1)), "Eval cache size must be a power of two");
+    static std::unique_ptr<EvalEntry[]> evalCache;
+
+    static constexpr bool trackEvalCacheStats = EVAL_CACHE_STATS;
+    static thread_local uint64_t threadEvalProbes;
+    static thread_local uint64_t threadEvalHits;
+    static std::atomic<uint64_t> evalProbes;
+    static std::atomic<uint64_t> evalHits;
 
     using cache_key = Board;
-    using cache_value = std::tuple<int, int, SearchBoundary, Move, int, int, int>;
+    using cache_value = std::tuple<int, int, SearchBoundary, Move>;
     using cache_pointer_type = Cache<cache_key, cache_value, (static_cast<uint64_t>(CACHE_MB) << 20ul) / sizeof(Cache<cache_key, cache_value, 1>)>;
     static std::unique_ptr<cache_pointer_type> boardCache;
 
     static const Move emptyMove;
+    static constexpr bool usePseudoLegalSearch = PSEUDO_LEGAL_SEARCH;
+    static constexpr bool useCopyMake = COPY_MAKE_SEARCH;
+    static constexpr int NUM_SEARCH_STAGES = 2;
     
-    std::array<Move, 6 * INNER_BOARD_SIZE * INNER_BOARD_SIZE> counterMove; 
+    std::array<Move, 6 * INNER_BOARD_SIZE * INNER_BOARD_SIZE> counterMove{}; 
     
     int DEPTH = 7;
     
     bool isWhitePlayer = false;
 
     Board *gameBoard;
+    PositionHistory *gameHistory;
+    //The game history followed by the moves each search thread has made below the root
+    static thread_local PositionHistory searchHistory;
     
     Move prev = Move();
-    int previousToSquareIndex = -1;
+    int previousCounterMoveIndex = -1;
 
     std::atomic_bool usingTimeLimit{false};
     std::condition_variable cv;
@@ -94,18 +170,30 @@ class AI {
 
     std::thread timeLimitThread;
 
-    int reduceKnightMobilityScore(const std::vector<Move>& moveList, const int cornerIndex, const Board& board) const;
-    std::tuple<Move, int, int, int, int> iterativeDeepening();
-    std::tuple<Move, int, int, int, int> MTD(const int guess, const int depth, Board& board);
-    std::tuple<Move, int, int, int, int> AlphaBeta(const int alpha, const int beta, const int depth, Board& board);
+    template<Colour colour>
+    int evaluateMobility(const Board& board) const;
+    template<Colour colour>
+    int evaluatePieces(const Board& board, const bool isEndGame) const;
+    template<Colour colour>
+    int evaluatePawnStructure(const Board& board) const;
+    const PawnEntry& probePawnTable(const Board& board) const;
+    int computeEvaluation(Board& board);
+    void printEvalCacheStats() const;
+    std::pair<Move, int> iterativeDeepening();
+    std::pair<Move, int> MTD(const int guess, const int depth, Board& board);
+    std::pair<Move, int> AlphaBeta(const int alpha, const int beta, const int depth, Board& board);
+    std::pair<Move, int> searchMove(const Move mv, const int alpha, const int beta, const int depth, Board& board);
     int getPieceValue(const PieceTypes type) const;
+    static MoveList generateSearchMoves(const Board& board, const int stage);
+    static PieceTypes getCapturedType(const Move mv, const Board& board);
+    static bool isCapture(const Move mv, const Board& board);
     unsigned long long perft(int depth, Board& board);
+    unsigned long long perftMove(const Move mv, const int depth, Board& board);
     unsigned long long perftDivide(int depth, Board& board);
-    std::vector<Move> orderMoveList(std::vector<Move>&& list, Board& board);
-    void translateMovePointers(Board& b, Move& mv, std::tuple<int, int, int> conversionOffsets);
+    void orderMoveList(MoveList& list, const Board& board) const;
     
 public:
-    AI(Board *b);
+    AI(Board *b, PositionHistory *h);
     ~AI();
     int evaluate(Board& board);
     std::string search();
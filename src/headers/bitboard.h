@@ -0,0 +1,183 @@
+/**
+* This is part of ChessPlusPlus, a C++14 Chess AI
+* Copyright (C) 2017 John Agapeyev
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "enums.h"
+
+/**
+ * A bitboard is a 64 bit set where each bit represents a square on the board.
+ * Bit 0 is a1, bit 7 is h1, and bit 63 is h8.
+ */
+using Bitboard = uint64_t;
+
+constexpr Bitboard FILE_A_MASK = 0x0101010101010101ull;
+constexpr Bitboard FILE_H_MASK = FILE_A_MASK << 7;
+constexpr Bitboard RANK_1_MASK = 0xFFull;
+constexpr Bitboard RANK_8_MASK = RANK_1_MASK << 56;
+
+/**
+ * Square index deltas for each direction a piece can move in.
+ * The four straight directions come first, followed by the four diagonals.
+ */
+constexpr int NUM_DIRECTIONS = 8;
+constexpr int DIRECTION_DELTAS[NUM_DIRECTIONS] = {8, -8, 1, -1, 9, 7, -7, -9};
+
+constexpr Bitboard squareMask(const int square) {
+    return 1ull << square;
+}
+
+constexpr int getRank(const int square) {
+    return square >> 3;
+}
+
+constexpr int getFile(const int square) {
+    return square & 7;
+}
+
+constexpr int makeSquare(const int rank, const int file) {
+    return (rank << 3) + file;
+}
+
+inline int popCount(const Bitboard b) {
+    return __builtin_popcountll(b);
+}
+
+inline int getLowestSquare(const Bitboard b) {
+    return __builtin_ctzll(b);
+}
+
+inline int getHighestSquare(const Bitboard b) {
+    return 63 ^ __builtin_clzll(b);
+}
+
+/**
+ * Returns an 8 bit mask of the files holding at least one of the given squares, with bit 0 being the a file.
+ */
+inline uint8_t getOccupiedFiles(Bitboard b) {
+    b |= b >> 32;
+    b |= b >> 16;
+    b |= b >> 8;
+    return static_cast<uint8_t>(b);
+}
+
+/**
+ * Returns the lowest set square and removes it from the bitboard.
+ * This is the main way of iterating over the pieces in a set.
+ */
+inline int popLowestSquare(Bitboard& b) {
+    const int square = __builtin_ctzll(b);
+    b &= b - 1;
+    return square;
+}
+
+/**
+ * A fixed size lookup table that can be filled in during constant evaluation.
+ * std::array cannot be written to in a C++14 constexpr function, so a plain array is wrapped instead.
+ */
+template<typename T, int N = 64>
+struct ConstTable {
+    T values[N];
+    constexpr T& operator[](const int i) {return values[i];}
+    constexpr const T& operator[](const int i) const {return values[i];}
+};
+
+/*
+ * Attack and geometry tables, generated at compile time.
+ * PAWN_ATTACKS is indexed by colour index then square, RAYS by direction then square,
+ * and BETWEEN and LINE by a pair of squares.
+ * BETWEEN holds the squares strictly between two aligned squares, 
+ * and LINE holds the entire line passing through them, both being empty if the squares are not aligned.
+ */
+extern const ConstTable<ConstTable<Bitboard>, 2> PAWN_ATTACKS;
+extern const ConstTable<Bitboard> KNIGHT_ATTACKS;
+extern const ConstTable<Bitboard> KING_ATTACKS;
+extern const ConstTable<ConstTable<Bitboard>, NUM_DIRECTIONS> RAYS;
+extern const ConstTable<ConstTable<Bitboard>> BETWEEN;
+extern const ConstTable<ConstTable<Bitboard>> LINE;
+
+inline Bitboard getPawnAttacks(const int square, const Colour colour) {
+    return PAWN_ATTACKS[getColourIndex(colour)][square];
+}
+
+/**
+ * Returns every square attacked by a set of pawns of the given colour.
+ */
+inline Bitboard getPawnAttackSet(const Bitboard pawns, const Colour colour) {
+    if (colour == Colour::WHITE) {
+        return ((pawns << 7) & ~FILE_H_MASK) | ((pawns << 9) & ~FILE_A_MASK);
+    }
+    return ((pawns >> 9) & ~FILE_H_MASK) | ((pawns >> 7) & ~FILE_A_MASK);
+}
+
+inline Bitboard getKnightAttacks(const int square) {
+    return KNIGHT_ATTACKS[square];
+}
+
+inline Bitboard getKingAttacks(const int square) {
+    return KING_ATTACKS[square];
+}
+
+/**
+ * The piece types that could attack from one square to another on an empty board,
+ * as a mask of 1 << getPieceIndex(type), along with the square delta a slider or king steps by to get there.
+ * Pawns are not included, as their attacks depend on colour.
+ */
+struct DeltaAttack {
+    uint8_t pieceTypes;
+    int8_t step;
+};
+
+/*
+ * Two squares are mapped to a delta index by spreading them onto a 16 wide board, as in 0x88.
+ * The difference between the spread squares is then unique for every rank and file offset,
+ * so a single 240 entry table covers every pair of squares.
+ */
+constexpr int NUM_SQUARE_DELTAS = 240;
+extern const ConstTable<DeltaAttack, NUM_SQUARE_DELTAS> DELTA_ATTACKS;
+
+constexpr int getDeltaIndex(const int from, const int to) {
+    return (to + (to & ~7)) - (from + (from & ~7)) + 119;
+}
+
+constexpr uint8_t getPieceTypeBit(const PieceTypes type) {
+    return 1 << getPieceIndex(type);
+}
+
+inline DeltaAttack getDeltaAttack(const int from, const int to) {
+    return DELTA_ATTACKS[getDeltaIndex(from, to)];
+}
+
+inline Bitboard getBetween(const int first, const int second) {
+    return BETWEEN[first][second];
+}
+
+inline Bitboard getLine(const int first, const int second) {
+    return LINE[first][second];
+}
+
+Bitboard getBishopAttacks(const int square, const Bitboard occupancy);
+Bitboard getRookAttacks(const int square, const Bitboard occupancy);
+
+inline Bitboard getQueenAttacks(const int square, const Bitboard occupancy) {
+    return getBishopAttacks(square, occupancy) | getRookAttacks(square, occupancy);
+}
+
+#endif
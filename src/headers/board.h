@@ -19,137 +19,168 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include <vector>
 #include <array>
-#include <memory>
+#include <type_traits>
 #include "hash.h"
 #include "consts.h"
 #include "enums.h"
 #include "move.h"
+#include "bitboard.h"
 
-class Square;
+class PositionHistory;
 
 /**
  * Main class for the chess engine.
- * It features a 15x15 vector based board containing an 8x8 board that shifts around
- * inside of it.
+ * The position is stored as a set of bitboards, one for each piece type and colour,
+ * along with an occupancy bitboard for each side.
+ * A mailbox of piece codes mirrors the bitboards to answer what is on a given square in constant time.
  * The board handles move making and unnmaking, piece movement, piece capturing and game ending states.
  * This class is also responsible for incrementally updating its own hash.
  */
 class Board {
-    /*
-     * Convert 15x15 board index that references square on the inner board, and
-     * convert it to the relative index of the inner board.
-     * Eg. If outerIndex references a2, this method returns the relative position
-     * of a2 regardless of the current board shift state.
-     */
-    static constexpr int convertOuterBoardIndex(const int outerIndex, const int cornerIndex) {
-        return (((outerIndex - cornerIndex) / OUTER_BOARD_SIZE) * INNER_BOARD_SIZE) 
-            + (outerIndex % OUTER_BOARD_SIZE) - (cornerIndex % OUTER_BOARD_SIZE);
-    }
-
-    static constexpr int genOffset(const int i, const int j) {
-        return 98 - (15 * i) + j;
-    }
-    
     /**
      * The move generator class handles all matters regarding move generation and validation,
      * including checking if a king is in check.
      */
     class MoveGenerator {
-        Board *board;
-        std::vector<Move> moveList;
-        std::vector<std::tuple<int, int, Piece*>> pieceCoords;
+        /**
+         * Selects which moves the shared generation routine produces.
+         */
+        enum GenerationType {
+            CAPTURES = 1,
+            QUIETS = 2,
+            ALL = CAPTURES | QUIETS
+        };
+        
+        const Board *board;
         void logMoveFailure(const int failureNum, const bool isSilent) const;
-        int getMoveOffset(const Move& mv) const;
+        void addMove(const Move mv, MoveList& moveList) const;
+        Bitboard getPinnedPieces(const Colour colour) const;
+        Bitboard getCheckTargets() const;
+        template<Colour colour>
+        void generatePawnMoves(const int fromSquare, const Bitboard legalTargets, 
+                const GenerationType genType, MoveList& moveList) const;
+        template<Colour colour, PieceTypes type>
+        void generatePieceMoves(const Bitboard targets, const Bitboard pinned, MoveList& moveList) const;
+        template<Colour colour, PieceTypes type>
+        int countPieceMoves(const Bitboard targets, const Bitboard pinned) const;
+        bool canCastle(const Colour colour, const bool isKingSide) const;
+        void generateCastling(const Colour colour, MoveList& moveList) const;
+        template<Colour colour>
+        void generateMoves(const GenerationType genType, const bool isLegalOnly, MoveList& moveList) const;
+        void generateMoves(const GenerationType genType, const bool isLegalOnly, MoveList& moveList) const;
+        template<Colour colour>
+        int countLegalMoves() const;
+        template<Colour colour, PieceTypes type>
+        bool hasPieceMove(const Bitboard targets, const Bitboard pinned) const;
+        template<Colour colour>
+        bool hasLegalMove() const;
         
     public:
-        MoveGenerator(Board *b) : board(b) {moveList.reserve(100); pieceCoords.reserve(16);}
+        MoveGenerator(const Board *b) : board(b) {}
         MoveGenerator(const MoveGenerator& m) = default;
         MoveGenerator(MoveGenerator&& m) = default;
         MoveGenerator& operator=(const MoveGenerator& m) = default;
         MoveGenerator& operator=(MoveGenerator&& m) = default;
 
-        bool operator==(const MoveGenerator& second) const {return *board == *second.board && moveList == second.moveList && pieceCoords == second.pieceCoords;}
+        bool operator==(const MoveGenerator& second) const {return *board == *second.board;}
 
-        static constexpr int getOffsetIndex(const int offset, const int startIndex = 0, const int vectorLen = 1) {
-            const auto absOffset = std::abs(offset);
-            const auto offsetVal = (vectorLen * ((30 * ((absOffset + INNER_BOARD_SIZE - 1) / OUTER_BOARD_SIZE)) - absOffset));
-            return startIndex + offsetVal - ((offset > 0) * offsetVal * 2);
-        }
-
-        std::vector<Move> generateAll();
-        bool validateMove(const Move& mv, const bool isSilent);
-        bool inCheck(const Move& mv) const;
-        bool inCheck(const int squareIndex) const;
+        MoveList generateAll() const;
+        MoveList generatePseudo() const;
+        MoveList generateCaptures() const;
+        MoveList generateQuiets() const;
+        MoveList generateEvasions() const;
+        int countLegalMoves() const;
+        bool hasLegalMove() const;
+        bool isLegal(const Move mv) const;
+        bool isPseudoLegal(const Move mv) const;
+        bool validateMove(const Move mv, const bool isSilent) const;
+        bool inCheck(const Move mv) const;
+        bool inCheck(const int squareIndex, const Colour friendlyColour) const;
+        bool inCheck(const int squareIndex, const Colour friendlyColour, const Bitboard occupancy, const Bitboard removed) const;
         Move createMove(std::string& input) const;
-        bool getCastleDirectionBool(const PieceTypes type, const Colour pieceColour, const int offset) const;
     };
-    MoveGenerator moveGen{this};
-    
-    std::array<std::unique_ptr<Square>, TOTAL_BOARD_SIZE> vectorTable;
+    std::array<Bitboard, NUM_SQUARE_STATES> pieceBoards{};
+    std::array<Bitboard, 2> colourBoards{};
+    std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> mailbox;
     GameState currentGameState = GameState::ACTIVE;
     unsigned char castleRights = 0x0F;
-    bool blackInCheck = false;
-    bool whiteInCheck = false;
+    std::array<int, 2> kingSquares{};
+    Bitboard checkers = 0;
     bool isWhiteTurn = true;
     bool enPassantActive = false;
-    Square *enPassantTarget = nullptr;
+    int enPassantTarget = -1;
     int halfMoveClock = 0;
     int moveCounter = 1;
     size_t currHash = 0;
-    std::array<size_t, 9> repititionList;
-    int cornerCache = -1;
+    //Keys of the pawns alone, and of the number of each piece type on the board
+    size_t pawnHash = 0;
+    size_t materialHash = 0;
     
-    void shiftVertical(const int count);
-    void shiftHorizontal(const int count);
+    MoveGenerator getMoveGen() const {return MoveGenerator{this};}
     std::string promptPromotionType() const;
     void updateCheckStatus();
     bool checkBoardValidity();
-    std::string convertSquareToCoordText(const Square *sq);
-    std::string convertMoveToCoordText(const Move& mv);
-    int getSquareIndex(const Square *sq);
-    bool checkEnPassantValidity(Square *sq, const Move& mv);
+    std::string convertSquareToCoordText(const int square) const;
+    std::string convertMoveToCoordText(const Move mv) const;
     void removeCastlingRights(const unsigned char flag);
-    void disableCastling(const Move& mv);
-    void performCastling(Move& mv, const int offset, const int fromSquareIndex);
-    void addEnPassantTarget(const Move& mv, const int offset, const int columnNum, const int endSquareIndex);
-    void captureEnPassant(const Move& mv, const int offset, const int toSquareIndex);
+    void disableCastling(const Move mv);
+    void performCastling(const Move mv, const Colour colour, const bool isUndo);
+    void addEnPassantTarget(const Move mv, const Colour colour);
+    void placePiece(const int square, const PieceTypes type, const Colour colour);
+    void removePiece(const int square, const PieceTypes type, const Colour colour);
     void hashPieceChange(const int index, const PieceTypes type, const Colour colour);
+    void hashMaterialChange(const PieceTypes type, const Colour colour, const int count);
+    size_t computePawnHash() const;
+    size_t computeMaterialHash() const;
     void hashTurnChange();
     void hashEnPassantFile(const int fileNum);
     void hashCastleRights();
-    void promotePawn(Move& mv, const int endSquareIndex, const bool isSilent);
-    void detectGameEnd();
+    void detectGameEnd(const PositionHistory& history);
 
 public:
     Board();
-    Board(const Board& b);
+    Board(const Board& b) = default;
     Board(Board&& b) = default;
     
-    Board& operator=(const Board& b);
+    Board& operator=(const Board& b) = default;
     Board& operator=(Board&& b) = default;
     bool operator==(const Board& second) const {return currHash == second.currHash;}
     
     void printBoardState() const;
-    auto& getBoard() const {return vectorTable;}
     auto getGameState() const {return currentGameState;}
     auto getCurrHash() const {return currHash;}
-    std::pair<int, int> findCorner();
-    int findCorner_1D();
-    void shiftBoard(const int col, const int row);
-    bool makeMove(std::string& input);
-    bool makeMove(Move& mv);
-    void unmakeMove(const Move& mv);
-    std::string generateFEN();
-    bool drawByMaterial();
+    auto getPawnHash() const {return pawnHash;}
+    auto getMaterialHash() const {return materialHash;}
+    auto getOccupancy() const {return colourBoards[0] | colourBoards[1];}
+    auto getColourBoard(const Colour colour) const {return colourBoards[getColourIndex(colour)];}
+    auto getPieceBoard(const PieceTypes type, const Colour colour) const {
+        return pieceBoards[getPieceCode(type, colour)];
+    }
+    auto getPieceCount(const PieceTypes type, const Colour colour) const {return popCount(getPieceBoard(type, colour));}
+    auto getKingSquare(const Colour colour) const {return kingSquares[getColourIndex(colour)];}
+    Bitboard attackersTo(const int square, const Bitboard occupancy) const;
+    PieceTypes getPieceType(const int square) const;
+    Colour getPieceColour(const int square) const;
+    bool makeMove(std::string& input, PositionHistory& history);
+    UndoInfo makeMove(const Move mv);
+    void unmakeMove(const Move mv, const UndoInfo& undo);
+    std::string generateFEN() const;
+    bool drawByMaterial() const;
     void setPositionByFEN(const std::string& fen);
     void setGameState(const GameState state) {currentGameState = state;}
     auto getWhiteTurn() const {return isWhiteTurn;}
+    auto getHalfMoveClock() const {return halfMoveClock;}
     
     friend class std::hash<Board>;
     friend class AI;
 };
 
+/*
+ * Boards are copied for every search thread, so they must stay plain values that can be copied
+ * with a memcpy, with no heap allocations or pointers back into themselves.
+ */
+static_assert(std::is_trivially_copyable<Board>::value, "Board must be trivially copyable");
+
 
 #endif
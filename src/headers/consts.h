@@ -20,7 +20,7 @@
 #define CONSTS_H
 
 #include <cstdint>
-#include "square.h"
+#include <array>
 
 /**
  * Various global constants used throughout the program.
@@ -28,24 +28,34 @@
  */
 
 constexpr uint_least8_t INNER_BOARD_SIZE = 8;
-constexpr uint_least8_t OUTER_BOARD_SIZE = 15;
-constexpr uint_least8_t TOTAL_BOARD_SIZE = OUTER_BOARD_SIZE * OUTER_BOARD_SIZE;
 constexpr uint_least8_t NUM_SQUARE_STATES = 12;
 
 /*
- * Value meaning:
- * 64 squares in a chess board
- * 12 states for each square
- * 1 for side to move
- * 16 for castling rights
- * 9 for en passant target file including empty
+ * Number of position hashes kept in a position history, which wraps around once full.
+ * A repetition cannot reach back past the fifty move rule, so the oldest entries can safely be overwritten.
+ * This must be a power of two.
  */
-constexpr uint_least16_t HASH_BOARD_LENGTH = (NUM_SQUARE_STATES * 64) + 1 + 16 + 9;
-constexpr std::pair<int, int> ZERO_LOCATION = std::make_pair(7, 7);
-constexpr uint_least8_t ZERO_LOCATION_1D = (ZERO_LOCATION.first * OUTER_BOARD_SIZE) + ZERO_LOCATION.second;
+constexpr uint_least16_t MAX_HISTORY_LENGTH = 256;
 
-extern const std::array<std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE>, INNER_BOARD_SIZE> INIT_BOARD;
-extern const std::array<uint_fast64_t, HASH_BOARD_LENGTH> HASH_VALUES;
+/*
+ * Zobrist keys follow the layout of the Polyglot opening book format:
+ * 768 piece keys indexed by 64 * kind + square, where kind is twice the piece index plus one for white,
+ * then one key per castling right in the order of the castling flags,
+ * then one key per en passant file, and lastly the key for white to move.
+ */
+constexpr uint_least16_t HASH_BOARD_LENGTH = (NUM_SQUARE_STATES * 64) + 4 + 8 + 1;
+constexpr uint_least16_t HASH_CASTLE_RIGHTS = NUM_SQUARE_STATES * 64;
+constexpr uint_least16_t HASH_EN_PASSANT_FILE = HASH_CASTLE_RIGHTS + 4;
+constexpr uint_least16_t HASH_WHITE_MOVE = HASH_EN_PASSANT_FILE + INNER_BOARD_SIZE;
+
+constexpr int getPieceHashIndex(const int square, const int pieceIndex, const bool isWhite) {
+    return (INNER_BOARD_SIZE * INNER_BOARD_SIZE * ((2 * pieceIndex) + isWhite)) + square;
+}
+
+extern const std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> INIT_BOARD;
+extern const std::array<uint64_t, HASH_BOARD_LENGTH> HASH_VALUES;
+//The combined key of every set of castling rights, indexed by the castling flags
+extern const std::array<uint64_t, 16> CASTLE_HASH_VALUES;
 extern const unsigned char BLACK_CASTLE_FLAG;
 extern const unsigned char WHITE_CASTLE_FLAG;
 extern const unsigned char WHITE_CASTLE_QUEEN_FLAG;
@@ -53,7 +63,6 @@ extern const unsigned char WHITE_CASTLE_KING_FLAG;
 extern const unsigned char BLACK_CASTLE_QUEEN_FLAG;
 extern const unsigned char BLACK_CASTLE_KING_FLAG;
 
-std::array<std::array<std::unique_ptr<Square>, INNER_BOARD_SIZE>, INNER_BOARD_SIZE> fillInitBoard();
-std::array<uint_fast64_t, HASH_BOARD_LENGTH> populateHashTable();
+std::array<uint8_t, INNER_BOARD_SIZE * INNER_BOARD_SIZE> fillInitBoard();
 
 #endif
@@ -19,7 +19,7 @@
 #ifndef ENUMS_H
 #define ENUMS_H
 
-#include <unordered_map>
+#include <cstdint>
 
 /**
  * Various enums used throughout the program
@@ -61,12 +61,7 @@ enum class SquareState : unsigned int {
     BLACK_BISHOP,
     BLACK_ROOK,
     BLACK_QUEEN,
-    BLACK_KING,
-    WHITE_MOVE = (12 * 64),
-    //Add current castle rights to this to get each combination
-    CASTLE_RIGHTS,
-    //Start at none and add 1-8 for A-H respectively
-    EN_PASSANT_FILE = (12 * 64) + 16 + 1
+    BLACK_KING
 };
 
 enum class SearchBoundary : unsigned char {
@@ -75,6 +70,53 @@ enum class SearchBoundary : unsigned char {
     EXACT
 };
 
-extern const std::unordered_map<PieceTypes, int> pieceLookupTable;
+constexpr PieceTypes PIECE_TYPE_LIST[] = {
+    PieceTypes::PAWN,
+    PieceTypes::KNIGHT,
+    PieceTypes::BISHOP,
+    PieceTypes::ROOK,
+    PieceTypes::QUEEN,
+    PieceTypes::KING
+};
+
+/**
+ * Returns the index of a piece type, matching the SquareState ordering.
+ */
+constexpr int getPieceIndex(const PieceTypes type) {
+    switch (type) {
+        case PieceTypes::PAWN:
+            return 0;
+        case PieceTypes::KNIGHT:
+            return 1;
+        case PieceTypes::BISHOP:
+            return 2;
+        case PieceTypes::ROOK:
+            return 3;
+        case PieceTypes::QUEEN:
+            return 4;
+        case PieceTypes::KING:
+            return 5;
+        default:
+            return -1;
+    }
+}
+
+constexpr int getColourIndex(const Colour colour) {
+    return colour == Colour::BLACK;
+}
+
+constexpr Colour getOppositeColour(const Colour colour) {
+    return (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+}
+
+/**
+ * Piece codes stored in the board mailbox follow the SquareState ordering,
+ * with one extra code representing an empty square.
+ */
+constexpr uint8_t EMPTY_SQUARE = static_cast<uint8_t>(SquareState::BLACK_KING) + 1;
+
+constexpr uint8_t getPieceCode(const PieceTypes type, const Colour colour) {
+    return (getColourIndex(colour) * 6) + getPieceIndex(type);
+}
 
 #endif
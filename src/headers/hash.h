@@ -23,7 +23,6 @@
 #include <functional>
 
 class Board;
-class Piece;
 
 /**
  * Template specialization of the std::hash class for use
@@ -35,12 +34,6 @@ namespace std {
     public:
         size_t operator() (Board& b) const;
     };
-
-    template<>
-    class hash<Piece> {
-    public:
-        size_t operator() (const Piece& p) const;
-    };
 }
 
 #endif
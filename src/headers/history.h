@@ -0,0 +1,46 @@
+/**
+* This is part of ChessPlusPlus, a C++14 Chess AI
+* Copyright (C) 2017 John Agapeyev
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <array>
+#include <cstddef>
+#include <cassert>
+#include "consts.h"
+#include "board.h"
+
+/**
+ * The hashes of the positions played before the current one, used to detect repeated positions.
+ * This is kept alongside a board rather than inside it, so copying a board only copies the position.
+ * One of these follows the game board, and each search thread keeps its own copy for the moves it searches.
+ */
+class PositionHistory {
+    std::array<size_t, MAX_HISTORY_LENGTH> keys;
+    unsigned int length = 0;
+
+public:
+    void push(const size_t hash) {keys[length++ % MAX_HISTORY_LENGTH] = hash;}
+    void pop() {assert(length > 0); --length;}
+    void clear() {length = 0;}
+    auto size() const {return length;}
+    int countRepetitions(const Board& board, const int limit) const;
+    bool isRepetition(const Board& board) const {return countRepetitions(board, 1) > 0;}
+};
+
+#endif
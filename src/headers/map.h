@@ -20,6 +20,7 @@
 #define MAP_H
 
 #include <cstdint>
+#include <vector>
 #include <mutex>
 
 /**
@@ -28,11 +29,20 @@
  * and since my key value was large (~1KiB) it was a waste of memory for something that was fixed size.
  * This container originally used chaining to resolve collisions, though that had 
  * an unacceptable level of memory growth, so it was replaced with this fixed memory scheme.
+ * Each bucket holds a single entry and a valid flag, so the buckets are allocated once
+ * on construction and inserting never allocates. A colliding insert replaces the old entry.
  */
 template<typename Key, typename Value, uint64_t maxSize, typename Hash = std::hash<Key>>
 class CacheMap {
     static_assert(maxSize > 0, "Size must be greater than zero");
-    std::vector<std::vector<std::pair<Value, size_t>>> internalArray{maxSize};
+
+    struct Bucket {
+        Value value{};
+        size_t hash = 0;
+        bool valid = false;
+    };
+
+    std::vector<Bucket> internalArray{maxSize};
     Hash hashEngine{};
 
     std::mutex mut;
@@ -48,66 +58,45 @@ public:
     
     void insert(const Key& k, const Value& v) {
         std::lock_guard<std::mutex> lock(mut);
-        if (internalArray[getBoundedHash(k)].empty()) {
-            internalArray[getBoundedHash(k)].emplace_back(v, hashEngine(k));
-        } else {
-            internalArray[getBoundedHash(k)][0] = std::make_pair(v, hashEngine(k));
-        }
+        internalArray[getBoundedHash(k)] = Bucket{v, hashEngine(k), true};
     }
     
     Value& operator[](const Key& k) {
-        const auto bounded = getBoundedHash(k);
         const auto fullHash = hashEngine(k);
         
-        {
-            std::lock_guard<std::mutex> lock(mut);
-
-            if (internalArray[bounded].empty()) {
-                insert(k, Value());
-                return internalArray[bounded].back().first;
-            }
+        std::lock_guard<std::mutex> lock(mut);
+        auto& bucket = internalArray[getBoundedHash(k)];
 
-            for (auto& p : internalArray[bounded]) {
-                if (p.second == fullHash) {
-                    return p.first;
-                }
-            }
+        //If the element isn't stored, replace the bucket with a default element and return that
+        if (!bucket.valid || bucket.hash != fullHash) {
+            bucket = Bucket{Value(), fullHash, true};
         }
-        
-        /*
-         * In the event element wasn't inserted due to empty chain, and
-         * an existing element wasn't found, insert a default element and return that
-         */
-        insert(k, Value());
-
-        std::lock_guard<std::mutex> lock(mut);
-        return internalArray[bounded].back().first;
+        return bucket.value;
     }
     
     bool find(const Key& k) {
-        const auto bounded = getBoundedHash(k);
         const auto fullHash = hashEngine(k);
         
         std::lock_guard<std::mutex> lock(mut);
-        for (const auto& p : internalArray[bounded]) {
-            if (p.second == fullHash) {
-                return true;
-            }
-        }
-        return false;
+        const auto& bucket = internalArray[getBoundedHash(k)];
+        return bucket.valid && bucket.hash == fullHash;
     }
     
     void erase(const Key& k) {
-        //Erase vector by replacing it with its default state
+        const auto fullHash = hashEngine(k);
+
+        //Only erase the bucket if it holds this key rather than a colliding one
         std::lock_guard<std::mutex> lock(mut);
-        internalArray[getBoundedHash(k)].clear();
+        auto& bucket = internalArray[getBoundedHash(k)];
+        if (bucket.hash == fullHash) {
+            bucket.valid = false;
+        }
     }
     
     void clear() {
-        //Clears the entire array by resetting it back to default values
         std::lock_guard<std::mutex> lock(mut);
-        for (const auto& elem : internalArray) {
-            elem.clear();
+        for (auto& bucket : internalArray) {
+            bucket.valid = false;
         }
     }
 };
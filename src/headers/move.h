@@ -20,39 +20,115 @@
 #define MOVE_H
 
 #include <iostream>
-#include "square.h"
-#include "piece.h"
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <cassert>
 #include "enums.h"
+#include "bitboard.h"
 
+/**
+ * A move packed into 16 bits.
+ * Bits 0-5 hold the starting square, bits 6-11 the ending square,
+ * bits 12-13 the promotion piece and bits 14-15 the type of move.
+ * A default constructed move is left uninitialized, so a move list can be created without zeroing its storage.
+ * A value initialized move, Move{}, has both squares set to a1 and is never a legal move.
+ */
 struct Move {
-    Move();
-    Move(const Move& mv) = default;
-    Move(Move&& mv) = default;
+    enum Flag : uint16_t {
+        NORMAL,
+        PROMOTION,
+        EN_PASSANT,
+        CASTLE
+    };
 
-    Move& operator=(const Move& mv) = default;
-    Move& operator=(Move&& mv) = default;
-    
-    Square *fromSq;
-    Square *toSq;
-    PieceTypes fromPieceType;
-    Colour fromPieceColour;
-    bool captureMade;
-    PieceTypes toPieceType;
-    Colour toPieceColour;
-    PieceTypes promotionType;
-    bool promotionMade;
-    bool isCastle;
-    unsigned char castleRights;
-    bool enPassantActive;
-    Square *enPassantTarget;
-    int halfMoveClock;
-    int moveCounter;
+    uint16_t data;
+
+    Move() = default;
+    constexpr Move(const int from, const int to, const Flag flag = NORMAL, 
+            const PieceTypes promotion = PieceTypes::KNIGHT) 
+        : data(from | (to << 6) | (encodePromotion(promotion) << 12) | (flag << 14)) {}
+
+    constexpr int getFromSq() const {return data & 0x3F;}
+    constexpr int getToSq() const {return (data >> 6) & 0x3F;}
+    constexpr Flag getFlag() const {return static_cast<Flag>(data >> 14);}
+    constexpr bool isPromotion() const {return getFlag() == PROMOTION;}
+    constexpr bool isEnPassant() const {return getFlag() == EN_PASSANT;}
+    constexpr bool isCastle() const {return getFlag() == CASTLE;}
+    constexpr PieceTypes getPromotionType() const {return decodePromotion((data >> 12) & 0x03);}
+
+private:
+    static constexpr uint16_t encodePromotion(const PieceTypes type) {
+        return (type == PieceTypes::QUEEN) ? 3 : (type == PieceTypes::ROOK) ? 2 : (type == PieceTypes::BISHOP) ? 1 : 0;
+    }
+    static constexpr PieceTypes decodePromotion(const int code) {
+        return (code == 3) ? PieceTypes::QUEEN : (code == 2) ? PieceTypes::ROOK 
+            : (code == 1) ? PieceTypes::BISHOP : PieceTypes::KNIGHT;
+    }
 };
 
-void swapOffsets(const Move& mv);
+/**
+ * Irreversible board state saved when a move is made, so the move can later be unmade.
+ * The caller that makes the move keeps this on its own stack until the move is unmade.
+ */
+struct UndoInfo {
+    size_t hash = 0;
+    Bitboard checkers = 0;
+    uint16_t halfMoveClock = 0;
+    uint16_t moveCounter = 0;
+    int8_t enPassantTarget = -1;
+    bool enPassantActive = false;
+    unsigned char castleRights = 0;
+    PieceTypes capturedType = PieceTypes::UNKNOWN;
+};
+
+constexpr bool operator==(const Move first, const Move second) {
+    return first.data == second.data;
+}
+
+constexpr bool operator!=(const Move first, const Move second) {
+    return first.data != second.data;
+}
+
+/**
+ * A list of moves with a fixed capacity, stored inline so that generating moves never allocates.
+ * The capacity is above the most pseudo-legal moves possible in any reachable position.
+ */
+class MoveList {
+    static constexpr size_t MAX_MOVES = 256;
+    
+    std::array<Move, MAX_MOVES> moves;
+    size_t count = 0;
+    
+public:
+    //User provided so that even MoveList{} leaves the move storage uninitialized
+    MoveList() {}
+
+    void push_back(const Move mv) {
+        assert(count < MAX_MOVES);
+        moves[count++] = mv;
+    }
+    
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        assert(count < MAX_MOVES);
+        moves[count++] = Move(std::forward<Args>(args)...);
+    }
+    
+    void clear() {count = 0;}
+    size_t size() const {return count;}
+    bool empty() const {return count == 0;}
+    
+    Move& operator[](const size_t i) {return moves[i];}
+    Move operator[](const size_t i) const {return moves[i];}
+    
+    Move *begin() {return moves.data();}
+    Move *end() {return moves.data() + count;}
+    const Move *begin() const {return moves.data();}
+    const Move *end() const {return moves.data() + count;}
+};
 
-bool operator==(const Move& first, const Move& second);
-bool operator!=(const Move& first, const Move& second);
-std::ostream& operator<<(std::ostream& os, const Move& mv);
+std::ostream& operator<<(std::ostream& os, const Move mv);
 
 #endif
@@ -20,97 +20,151 @@
 #define TT_H
 
 #include <vector>
-#include <list>
 #include <cstdint>
 #include <mutex>
 #include <atomic>
+#include <cassert>
 #include "map.h"
 
 /**
  * Cache is a fixed size thread-safe transposition table container for the AI.
  * It is organized as an LRU cache implemented over a linked list of key value pairs,
- * and a fixed size custom hashmap storing keys and linked list iterators.
+ * and a fixed size custom hashmap storing keys and the index of their list node.
  * When an element is accessed, it is moved to the front of the linked list.
  * This creates a temporal queue of access based on the order of the linked list entries.
- * When the max size is reached, the tail of the linked list - representing the least recently accessed element
- * is deleted along with the associated element in the hashmap.
+ * When the max size is reached, the node at the tail of the linked list - representing the least recently
+ * accessed element - is reused for the new element, and the old element is removed from the hashmap.
+ * The list nodes live in a pool reserved on construction and are linked by index,
+ * so adding an element never allocates.
  *
  * Complexity details:
  * Insertion O(1)
  * Deletion O(1)
  * Retrieval O(1)
- * Erase O(n)
+ * Erase O(1)
  * Space O(n)
  */
 template<typename Key, typename Value, uint64_t maxSize, typename Hash = std::hash<Key>>
 class Cache {
     static_assert(maxSize > 0, "Size must be greater than 0");
+    static_assert(maxSize < UINT32_MAX, "Size must fit in a node index");
 
-    using CacheEntry = std::pair<size_t, Value>;
-    using CacheList = std::list<CacheEntry>;
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct CacheNode {
+        size_t hash;
+        Value value;
+        uint32_t prev;
+        uint32_t next;
+    };
     
-    CacheList internalList;
-    CacheMap<size_t, typename CacheList::iterator, maxSize> internalMap;
+    std::vector<CacheNode> nodePool;
+    uint32_t head = NO_NODE;
+    uint32_t tail = NO_NODE;
+    CacheMap<size_t, uint32_t, maxSize> internalMap;
     Hash hashEngine{};
     std::atomic_size_t currSize{0};
 
     std::mutex mut;
     
-    void overwrite() {
-        {
-            std::lock_guard<std::mutex> lock(mut);
-            internalMap.erase(internalList.back().first);
-            internalList.pop_back();
-        }
-        --currSize;
+    void unlink(const uint32_t index) {
+        auto& node = nodePool[index];
+        ((node.prev == NO_NODE) ? head : nodePool[node.prev].next) = node.next;
+        ((node.next == NO_NODE) ? tail : nodePool[node.next].prev) = node.prev;
     }
-    
-    void add(const CacheEntry& newEntry) {
-        if (currSize.load() >= maxSize) {
-            overwrite();
+
+    void pushFront(const uint32_t index) {
+        auto& node = nodePool[index];
+        node.prev = NO_NODE;
+        node.next = head;
+        ((head == NO_NODE) ? tail : nodePool[head].prev) = index;
+        head = index;
+    }
+
+    void pushBack(const uint32_t index) {
+        auto& node = nodePool[index];
+        node.prev = tail;
+        node.next = NO_NODE;
+        ((tail == NO_NODE) ? head : nodePool[tail].next) = index;
+        tail = index;
+    }
+
+    /**
+     * Returns the node to store a new element in, taking an unused pool node
+     * until the pool is full, and then reusing the least recently accessed node.
+     */
+    uint32_t claimNode() {
+        if (nodePool.size() < maxSize) {
+            nodePool.emplace_back();
+            return nodePool.size() - 1;
         }
+        const auto index = tail;
+        unlink(index);
 
-        {
-            std::lock_guard<std::mutex> lock(mut);
-            internalList.push_front(newEntry);
-            internalMap.insert(newEntry.first, internalList.begin());
+        //The hashmap may already point elsewhere if a colliding element replaced this one
+        if (internalMap.find(nodePool[index].hash) && internalMap[nodePool[index].hash] == index) {
+            internalMap.erase(nodePool[index].hash);
+        }
+        return index;
+    }
+    
+    void add(const size_t hash, const Value& v) {
+        std::lock_guard<std::mutex> lock(mut);
+        uint32_t index;
+        if (internalMap.find(hash)) {
+            index = internalMap[hash];
+            unlink(index);
+        } else {
+            index = claimNode();
+            internalMap.insert(hash, index);
         }
-        ++currSize;
+        nodePool[index].hash = hash;
+        nodePool[index].value = v;
+        pushFront(index);
+        currSize = nodePool.size();
     }
     
 public:
+    Cache() {
+        nodePool.reserve(maxSize);
+    }
 
     void erase(Key& k) {
-        {
-            std::lock_guard<std::mutex> lock(mut);
-            internalList.erase(internalMap[hashEngine(k)]);
+        const auto hash = hashEngine(k);
+        std::lock_guard<std::mutex> lock(mut);
+        if (!internalMap.find(hash)) {
+            return;
         }
-        internalMap.erase(hashEngine(k));
+        //Moving the node to the back means it is the next one reused
+        const auto index = internalMap[hash];
+        unlink(index);
+        pushBack(index);
+        internalMap.erase(hash);
     }
     
     void clear() {
-        {
-            std::lock_guard<std::mutex> lock(mut);
-            internalList.clear();
-        }
+        std::lock_guard<std::mutex> lock(mut);
+        nodePool.clear();
+        head = NO_NODE;
+        tail = NO_NODE;
         internalMap.clear();
         currSize = 0;
     }
     
     void add(Key& k, const Value& v) {
-        add(std::make_pair(hashEngine(k), v));
+        add(hashEngine(k), v);
     }
     
     Value& operator[](Key& k) {
-        const auto elem = internalMap[hashEngine(k)];
-        {
-            std::lock_guard<std::mutex> lock(mut);
-            assert(elem != internalList.end());
-            if (elem != internalList.begin() && elem != internalList.end()) {
-                internalList.splice(internalList.begin(), internalList, elem);
-            }
+        const auto hash = hashEngine(k);
+        std::lock_guard<std::mutex> lock(mut);
+        assert(internalMap.find(hash));
+        const auto index = internalMap[hash];
+        if (index != head) {
+            unlink(index);
+            pushFront(index);
         }
-        return elem->second;
+        return nodePool[index].value;
     }
     
     bool retrieve(Key& k) {